@@ -61,6 +61,30 @@ vector<string> util::splitInputLine(const string& line) {
   return words;
 }
 
+void util::writeVarint(string& bytes, Int num) {
+  assert(num >= 0);
+  while (num >= 0x80) {
+    bytes.push_back(static_cast<char>((num & 0x7f) | 0x80));
+    num >>= 7;
+  }
+  bytes.push_back(static_cast<char>(num));
+}
+
+bool util::readVarint(const string& bytes, size_t& pos, Int& num) {
+  num = 0;
+  for (Int shift = 0; shift < 63; shift += 7) {
+    if (pos >= bytes.size()) {
+      return false;
+    }
+    unsigned char byte = bytes[pos++];
+    num |= static_cast<Int>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return num >= 0;
+    }
+  }
+  return false;
+}
+
 void util::printInputLine(const string& line, Int lineIndex) {
   cout << "c line " << right << setw(5) << lineIndex << ":" << (line.empty() ? "" : " " + line) << "\n";
 }
@@ -105,10 +129,10 @@ Number::Number(Float f) {
 
 Number::Number(const Number& n) {
   if (multiplePrecision) {
-    *this = Number(n.quotient);
+    quotient = n.quotient;
   }
   else {
-    *this = Number(n.fraction);
+    fraction = n.fraction;
   }
 }
 
@@ -134,6 +158,16 @@ Number::Number(const string& repr) {
   }
 }
 
+Number& Number::operator=(const Number& n) {
+  if (multiplePrecision) {
+    quotient = n.quotient;
+  }
+  else {
+    fraction = n.fraction;
+  }
+  return *this;
+}
+
 Number Number::getAbsolute() const {
   if (multiplePrecision) {
     return Number(abs(quotient));
@@ -335,17 +369,31 @@ bool Label::hasSmallerLabel(const pair<Int, Label>& a, const pair <Int, Label>&
 
 /* class Clause ============================================================= */
 
-Clause::Clause(bool xorFlag) {
+Clause::Clause(const Int* literalsBegin, const Int* literalsEnd, const Int* sortedLiteralsBegin, bool xorFlag) {
+  this->literalsBegin = literalsBegin;
+  this->literalsEnd = literalsEnd;
+  this->sortedLiteralsBegin = sortedLiteralsBegin;
   this->xorFlag = xorFlag;
 }
 
-void Clause::insertLiteral(Int literal) {
-  if (xorFlag && contains(literal)) {
-    erase(literal);
-  }
-  else {
-    insert(literal);
-  }
+const Int* Clause::begin() const {
+  return literalsBegin;
+}
+
+const Int* Clause::end() const {
+  return literalsEnd;
+}
+
+size_t Clause::size() const {
+  return literalsEnd - literalsBegin;
+}
+
+bool Clause::empty() const {
+  return literalsBegin == literalsEnd;
+}
+
+bool Clause::contains(Int literal) const {
+  return std::binary_search(sortedLiteralsBegin, sortedLiteralsBegin + size(), literal);
 }
 
 void Clause::printClause() const {
@@ -364,6 +412,322 @@ Set<Int> Clause::getClauseVars() const {
   return vars;
 }
 
+void Clause::normalizeLiterals(vector<Int>& literals, bool xorFlag) {
+  Set<Int> literalSet; // iteration order is what planner heuristics have always seen
+  for (Int literal : literals) {
+    if (xorFlag && literalSet.contains(literal)) { // x XOR x = 0
+      literalSet.erase(literal);
+    }
+    else {
+      literalSet.insert(literal);
+    }
+  }
+  literals.assign(literalSet.begin(), literalSet.end());
+}
+
+/* class ClauseIterator ===================================================== */
+
+Clause ClauseIterator::operator*() const {
+  return clauseList->at(clauseIndex);
+}
+
+ClauseIterator& ClauseIterator::operator++() {
+  clauseIndex++;
+  return *this;
+}
+
+bool ClauseIterator::operator!=(const ClauseIterator& it) const {
+  return clauseIndex != it.clauseIndex;
+}
+
+/* class ClauseList ========================================================= */
+
+size_t ClauseList::size() const {
+  return xorFlags.size();
+}
+
+bool ClauseList::empty() const {
+  return xorFlags.empty();
+}
+
+Clause ClauseList::at(Int clauseIndex) const {
+  const Int* data = literals.data();
+  return Clause(data + offsets.at(clauseIndex), data + offsets.at(clauseIndex + 1), sortedLiterals.data() + offsets.at(clauseIndex), xorFlags.at(clauseIndex));
+}
+
+ClauseIterator ClauseList::begin() const {
+  return ClauseIterator{this, 0};
+}
+
+ClauseIterator ClauseList::end() const {
+  return ClauseIterator{this, static_cast<Int>(size())};
+}
+
+void ClauseList::append(const Clause& clause) {
+  literals.insert(literals.end(), clause.begin(), clause.end());
+  sortedLiterals.insert(sortedLiterals.end(), clause.sortedLiteralsBegin, clause.sortedLiteralsBegin + clause.size());
+  offsets.push_back(literals.size());
+  xorFlags.push_back(clause.xorFlag);
+}
+
+void ClauseList::append(const vector<Int>& normalizedLiterals, bool xorFlag) {
+  literals.insert(literals.end(), normalizedLiterals.begin(), normalizedLiterals.end());
+  sortedLiterals.insert(sortedLiterals.end(), normalizedLiterals.begin(), normalizedLiterals.end());
+  sort(sortedLiterals.end() - normalizedLiterals.size(), sortedLiterals.end());
+  offsets.push_back(literals.size());
+  xorFlags.push_back(xorFlag);
+}
+
+/* class InputBuffer ======================================================== */
+
+InputBuffer::InputBuffer(const string& filePath) {
+  int fd = open(filePath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw MyError("unable to open file '", filePath, "'");
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+    void* p = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p != MAP_FAILED) {
+      madvise(p, fileStat.st_size, MADV_WILLNEED); // chunks are read concurrently
+      mappedData = p;
+      data = static_cast<const char*>(p);
+      size = fileStat.st_size;
+    }
+  }
+
+  if (mappedData == nullptr) { // pipes and files that cannot be mapped
+    char block[1 << 16];
+    ssize_t byteCount;
+    while ((byteCount = read(fd, block, sizeof(block))) > 0) {
+      readData.append(block, byteCount);
+    }
+    if (byteCount < 0) {
+      close(fd);
+      throw MyError("unable to read file '", filePath, "'");
+    }
+    data = readData.data();
+    size = readData.size();
+  }
+  close(fd);
+}
+
+InputBuffer::~InputBuffer() {
+  releaseMap();
+}
+
+void InputBuffer::releaseMap() {
+  if (mappedData != nullptr) {
+    munmap(mappedData, size);
+    mappedData = nullptr;
+  }
+}
+
+string InputBuffer::getDecompressor() const {
+  for (const auto& [magic, decompressor] : COMPRESSION_MAGICS) {
+    if (size >= magic.size() && std::memcmp(data, magic.data(), magic.size()) == 0) {
+      return decompressor;
+    }
+  }
+  return "";
+}
+
+/* class DecompressionPipe ================================================== */
+
+DecompressionPipe::DecompressionPipe(const string& decompressor, const InputBuffer& inputBuffer, const string& filePath) {
+  this->decompressor = decompressor;
+  this->filePath = filePath;
+
+  int inPipe[2];
+  int outPipe[2];
+  if (pipe2(inPipe, O_CLOEXEC) != 0) {
+    throw MyError("unable to create pipe for '", decompressor, "'");
+  }
+  if (pipe2(outPipe, O_CLOEXEC) != 0) {
+    close(inPipe[0]);
+    close(inPipe[1]);
+    throw MyError("unable to create pipe for '", decompressor, "'");
+  }
+
+  posix_spawn_file_actions_t fileActions;
+  posix_spawn_file_actions_init(&fileActions);
+  posix_spawn_file_actions_adddup2(&fileActions, inPipe[0], STDIN_FILENO); // dup2 clears close-on-exec
+  posix_spawn_file_actions_adddup2(&fileActions, outPipe[1], STDOUT_FILENO);
+  string decompressFlag = "-dc";
+  char* argv[] = {const_cast<char*>(decompressor.c_str()), decompressFlag.data(), NULL};
+  int spawnStatus = posix_spawnp(&pid, decompressor.c_str(), &fileActions, NULL, argv, environ);
+  posix_spawn_file_actions_destroy(&fileActions);
+  close(inPipe[0]);
+  close(outPipe[1]);
+  if (spawnStatus != 0) {
+    pid = -1;
+    close(inPipe[1]);
+    close(outPipe[0]);
+    throw MyError("unable to run '", decompressor, "' on file '", filePath, "'");
+  }
+  outFd = outPipe[0];
+
+  oldSigpipeHandler = signal(SIGPIPE, SIG_IGN); // decompressor may exit early on corrupt input or when output is abandoned
+  feeder = std::thread([data = inputBuffer.data, size = inputBuffer.size, inFd = inPipe[1]]() { // compressed bytes go in while decompressed bytes come out
+    for (size_t offset = 0; offset < size;) {
+      ssize_t byteCount = write(inFd, data + offset, size - offset);
+      if (byteCount < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        break;
+      }
+      offset += byteCount;
+    }
+    close(inFd);
+  });
+}
+
+DecompressionPipe::~DecompressionPipe() {
+  if (pid >= 0) {
+    stop();
+  }
+}
+
+size_t DecompressionPipe::read(char* block, size_t capacity) {
+  while (true) {
+    ssize_t byteCount = ::read(outFd, block, capacity);
+    if (byteCount >= 0) {
+      return byteCount;
+    }
+    if (errno != EINTR) {
+      throw MyError("unable to decompress file '", filePath, "' with '", decompressor, "'");
+    }
+  }
+}
+
+void DecompressionPipe::finish() {
+  int waitStatus = stop();
+  if (!WIFEXITED(waitStatus) || WEXITSTATUS(waitStatus) != 0) {
+    throw MyError("unable to decompress file '", filePath, "' with '", decompressor, "'");
+  }
+}
+
+int DecompressionPipe::stop() {
+  close(outFd); // decompressor that is still writing gets EPIPE
+  outFd = -1;
+  feeder.join();
+  signal(SIGPIPE, oldSigpipeHandler);
+
+  int waitStatus = 0;
+  while (waitpid(pid, &waitStatus, 0) < 0 && errno == EINTR) {}
+  pid = -1;
+  return waitStatus;
+}
+
+/* class CnfChunk =========================================================== */
+
+bool CnfChunk::parseInt(const char*& p, const char* end, Int& num) {
+  const char* q = p;
+  bool negativeFlag = q < end && *q == '-';
+  q += negativeFlag;
+  Int value = 0;
+  Int digitCount = 0;
+  for (; q < end && *q >= '0' && *q <= '9'; q++, digitCount++) {
+    value = value * 10 + (*q - '0');
+  }
+  if (digitCount == 0 || digitCount > 18 || (q < end && !isspace(static_cast<unsigned char>(*q)))) { // left to stoll
+    return false;
+  }
+  num = negativeFlag ? -value : value;
+  p = q;
+  return true;
+}
+
+bool CnfChunk::findProblemLine(const char*& lineBegin, const char* end, Int& fastVarCount) {
+  while (lineBegin < end) {
+    const char* lineEnd = static_cast<const char*>(memchr(lineBegin, '\n', end - lineBegin));
+    lineEnd = lineEnd == nullptr ? end : lineEnd;
+    vector<string> words = util::splitInputLine(string(lineBegin, lineEnd));
+    if (!words.empty() && !words.front().starts_with("c")) {
+      if (words.size() == 4 && words.front() == "p") {
+        const char* p = words.at(2).data();
+        parseInt(p, p + words.at(2).size(), fastVarCount);
+      }
+      return true;
+    }
+    lineBegin = lineEnd + 1;
+  }
+  return false;
+}
+
+void CnfChunk::parseLines(const char* begin, const char* end, Int declaredVarCount, bool fastFlag) {
+  auto isSpace = [](char c) { return isspace(static_cast<unsigned char>(c)); };
+  vector<Int> literals; // reused by clause lines
+  for (const char* lineBegin = begin; lineBegin < end;) {
+    const char* lineEnd = static_cast<const char*>(memchr(lineBegin, '\n', end - lineBegin));
+    lineEnd = lineEnd == nullptr ? end : lineEnd;
+    lineCount++;
+
+    auto addSpecialLine = [&]() {
+      specialLines.push_back(std::string_view(lineBegin, lineEnd - lineBegin));
+      specialLineIndices.push_back(lineCount);
+      specialClauseCounts.push_back(clauses.size());
+    };
+
+    const char* p = lineBegin;
+    while (p < lineEnd && isSpace(*p)) {
+      p++;
+    }
+
+    if (!fastFlag || declaredVarCount < 0) {
+      addSpecialLine();
+    }
+    else if (p == lineEnd) {} // blank line
+    else if (*p == 'c') {
+      const char* q = p + 1;
+      if (q == lineEnd || isSpace(*q)) { // front word is "c": show or weight line has "p" as second word
+        while (q < lineEnd && isSpace(*q)) {
+          q++;
+        }
+        if (q < lineEnd && *q == 'p' && (q + 1 == lineEnd || isSpace(q[1]))) {
+          addSpecialLine();
+        }
+      }
+    }
+    else if (*p == 'x' || *p == '-' || (*p >= '0' && *p <= '9')) { // clause line
+      bool xorFlag = *p == 'x';
+      p += xorFlag;
+      literals.clear();
+      bool wellFormedFlag = false;
+      while (true) {
+        while (p < lineEnd && isSpace(*p)) {
+          p++;
+        }
+        Int num;
+        if (p == lineEnd || wellFormedFlag || !parseInt(p, lineEnd, num) || abs(num) > declaredVarCount) { // anything after "0" is malformed
+          wellFormedFlag = wellFormedFlag && p == lineEnd;
+          break;
+        }
+        if (num == 0) {
+          wellFormedFlag = true;
+        }
+        else {
+          literals.push_back(num);
+        }
+      }
+      Clause::normalizeLiterals(literals, xorFlag);
+      if (wellFormedFlag && !literals.empty()) {
+        clauses.append(literals, xorFlag);
+      }
+      else { // errors are reported sequentially with line index
+        addSpecialLine();
+      }
+    }
+    else {
+      addSpecialLine();
+    }
+
+    lineBegin = lineEnd + 1;
+  }
+}
+
 /* class Cnf ================================================================ */
 
 Set<Int> Cnf::getInnerVars() const {
@@ -407,25 +771,62 @@ void Cnf::printClauses() const {
   }
 }
 
-void Cnf::addClause(const Clause& clause) {
-  Int clauseIndex = clauses.size();
-  clauses.push_back(clause);
-  for (Int literal : clause) {
-    Int var = abs(literal);
-    auto it = varToClauses.find(var);
-    if (it != varToClauses.end()) {
-      it->second.insert(clauseIndex);
+std::span<const Int> Cnf::getVarClauses(Int var) const {
+  if (var + 1 >= static_cast<Int>(varClauseOffsets.size())) {
+    return std::span<const Int>();
+  }
+  return std::span<const Int>(varClauseIndices.data() + varClauseOffsets.at(var), varClauseIndices.data() + varClauseOffsets.at(var + 1));
+}
+
+void Cnf::addClause(vector<Int> literals, bool xorFlag) {
+  Clause::normalizeLiterals(literals, xorFlag);
+  clauses.append(literals, xorFlag);
+}
+
+void Cnf::setApparentVars() {
+  Int maxVar = declaredVarCount;
+  for (Int literal : clauses.literals) {
+    maxVar = max(maxVar, std::abs(literal));
+  }
+
+  vector<Int> lastClauseIndices(maxVar + 1, -1); // var |-> last counted clause, as clause may have both x and -x
+  varClauseOffsets.assign(maxVar + 2, 0);
+  for (Int clauseIndex = 0; clauseIndex < static_cast<Int>(clauses.size()); clauseIndex++) {
+    for (Int literal : clauses.at(clauseIndex)) {
+      Int var = abs(literal);
+      if (lastClauseIndices.at(var) != clauseIndex) {
+        lastClauseIndices.at(var) = clauseIndex;
+        varClauseOffsets.at(var + 1)++;
+      }
     }
-    else {
-      varToClauses[var] = {clauseIndex};
+  }
+  for (size_t var = 1; var < varClauseOffsets.size(); var++) {
+    varClauseOffsets.at(var) += varClauseOffsets.at(var - 1);
+  }
+
+  varClauseIndices.resize(varClauseOffsets.back());
+  vector<Int> nextPositions(varClauseOffsets.begin(), varClauseOffsets.end() - 1);
+  for (Int clauseIndex = 0; clauseIndex < static_cast<Int>(clauses.size()); clauseIndex++) {
+    for (Int literal : clauses.at(clauseIndex)) {
+      Int var = abs(literal);
+      Int& position = nextPositions.at(var);
+      if (position == varClauseOffsets.at(var) || varClauseIndices.at(position - 1) != clauseIndex) {
+        varClauseIndices.at(position++) = clauseIndex;
+      }
     }
   }
+
+  for (Int var : getClauseVars()) {
+    apparentVars.insert(var);
+  }
 }
 
-void Cnf::setApparentVars() {
-  for (const pair<Int, Set<Int>>& kv : varToClauses) {
-    apparentVars.insert(kv.first);
+Set<Int> Cnf::getClauseVars() const {
+  Set<Int> vars;
+  for (Int literal : clauses.literals) {
+    vars.insert(abs(literal));
   }
+  return vars;
 }
 
 Graph Cnf::getPrimalGraph() const {
@@ -462,8 +863,8 @@ vector<Int> Cnf::getDeclarationVarOrder() const {
 
 vector<Int> Cnf::getMostClausesVarOrder() const {
   multimap<Int, Int, greater<Int>> m; // clause count |-> var
-  for (const auto& [var, clauseIndices] : varToClauses) {
-    m.insert({clauseIndices.size(), var});
+  for (Int var : getClauseVars()) {
+    m.insert({getVarClauses(var).size(), var});
   }
 
   vector<Int> varOrder;
@@ -695,135 +1096,249 @@ void Cnf::printStats() const {
   util::printRow("clauseSizeMin", clauseSizeMin);
 }
 
-void Cnf::readCnfFile(const string& filePath) {
-  cout << "c processing CNF formula...\n";
+void Cnf::readCnfLine(const string& line, Int lineIndex, Int& problemLineIndex, Int& declaredClauseCount) {
+  if (verboseCnf >= 3) {
+    util::printInputLine(line, lineIndex);
+  }
 
-  std::ifstream inputFileStream(filePath);
-  if (!inputFileStream.is_open()) {
-    throw MyError("unable to open file '", filePath, "'");
+  vector<string> words = util::splitInputLine(line);
+  if (words.empty()) {
+    return;
+  }
+  string& frontWord = words.front();
+  if (frontWord == "s" || frontWord == "INDETERMINATE") { // preprocessor pmc
+    throw MyError("unexpected output from preprocessor pmc | line ", lineIndex, ": ", line);
   }
+  else if (frontWord == "p") { // problem line
+    if (problemLineIndex != MIN_INT) {
+      throw MyError("multiple problem lines: ", problemLineIndex, " and ", lineIndex);
+    }
 
-  Int declaredClauseCount = MIN_INT;
+    problemLineIndex = lineIndex;
 
-  Int lineIndex = 0;
-  Int problemLineIndex = MIN_INT;
+    if (words.size() != 4) {
+      throw MyError("problem line ", lineIndex, " has ", words.size(), " words (should be 4)");
+    }
 
-  string line;
-  while (getline(inputFileStream, line)) {
-    lineIndex++;
-    std::istringstream inStringStream(line);
+    declaredVarCount = stoll(words.at(2));
+    declaredClauseCount = stoll(words.at(3));
+  }
+  else if (frontWord == "c") { // possibly show or weight line
+    if (projectedCounting && isMc21ShowLine(words)) {
+      if (problemLineIndex == MIN_INT) {
+        throw MyError("no problem line before outer vars | line ", lineIndex, ": ", line);
+      }
 
-    if (verboseCnf >= 3) {
-      util::printInputLine(line, lineIndex);
+      for (size_t i = 3; i < words.size(); i++) {
+        Int num = stoll(words.at(i));
+        if (num == 0) {
+          if (i != words.size() - 1) {
+            throw MyError("outer vars terminated prematurely by '0' | line ", lineIndex);
+          }
+        }
+        else if (num < 0 || num > declaredVarCount) {
+          throw MyError("var '", num, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
+        }
+        else {
+          outerVars.insert(num);
+        }
+      }
     }
+    else if (weightedCountingMode > WeightedCountingMode::NO_VARS && isMc21WeightLine(words)) {
+      if (problemLineIndex == MIN_INT) {
+        throw MyError("no problem line before literal weight | line ", lineIndex, ": ", line);
+      }
 
-    vector<string> words = util::splitInputLine(line);
-    if (words.empty()) {
-      continue;
+      Int literal = stoll(words.at(3));
+      assert(literal != 0);
+
+      if (abs(literal) > declaredVarCount) {
+        throw MyError("literal '", literal, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
+      }
+
+      Number weight(words.at(4));
+      if (weight < Number()) {
+        cout << WARNING << "literal weight is negative | line " << lineIndex << ": " << line << "\n";
+        // throw MyError("literal weight must be non-negative | line ", lineIndex);
+      }
+      literalWeights[literal] = weight;
     }
-    string& frontWord = words.front();
-    if (Set<string>{"s", "INDETERMINATE"}.contains(frontWord)) { // preprocessor pmc
-      throw MyError("unexpected output from preprocessor pmc | line ", lineIndex, ": ", line);
+  }
+  else if (!frontWord.starts_with("c")) { // clause line
+    if (problemLineIndex == MIN_INT) {
+      throw MyError("no problem line before clause | line ", lineIndex);
     }
-    else if (frontWord == "p") { // problem line
-      if (problemLineIndex != MIN_INT) {
-        throw MyError("multiple problem lines: ", problemLineIndex, " and ", lineIndex);
+
+    bool xorFlag = false;
+    if (frontWord.starts_with("x")) {
+      xorFlag = true;
+      xorClauseCount++;
+
+      if (frontWord == "x") {
+        words.erase(words.begin());
+      }
+      else {
+        frontWord.erase(frontWord.begin());
       }
+    }
+    vector<Int> literals;
 
-      problemLineIndex = lineIndex;
+    for (size_t i = 0; i < words.size(); i++) {
+      Int num = stoll(words.at(i));
 
-      if (words.size() != 4) {
-        throw MyError("problem line ", lineIndex, " has ", words.size(), " words (should be 4)");
+      if (abs(num) > declaredVarCount) {
+        throw MyError("literal '", num, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
       }
 
-      declaredVarCount = stoll(words.at(2));
-      declaredClauseCount = stoll(words.at(3));
-    }
-    else if (frontWord == "c") { // possibly show or weight line
-      if (projectedCounting && isMc21ShowLine(words)) {
-        if (problemLineIndex == MIN_INT) {
-          throw MyError("no problem line before outer vars | line ", lineIndex, ": ", line);
+      if (num == 0) {
+        if (i != words.size() - 1) {
+          throw MyError("clause terminated prematurely by '0' | line ", lineIndex);
         }
 
-        for (Int i = 3; i < words.size(); i++) {
-          Int num = stoll(words.at(i));
-          if (num == 0) {
-            if (i != words.size() - 1) {
-              throw MyError("outer vars terminated prematurely by '0' | line ", lineIndex);
-            }
-          }
-          else if (num < 0 || num > declaredVarCount) {
-            throw MyError("var '", num, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
-          }
-          else {
-            outerVars.insert(num);
-          }
+        Clause::normalizeLiterals(literals, xorFlag);
+        if (literals.empty()) {
+          throw EmptyClauseException(lineIndex, line);
         }
+
+        clauses.append(literals, xorFlag);
       }
-      else if (weightedCountingMode > WeightedCountingMode::NO_VARS && isMc21WeightLine(words)) {
-        if (problemLineIndex == MIN_INT) {
-          throw MyError("no problem line before literal weight | line ", lineIndex, ": ", line);
+      else { // literal
+        if (i == words.size() - 1) {
+          throw MyError("missing end-of-clause indicator '0' | line ", lineIndex);
         }
+        literals.push_back(num);
+      }
+    }
+  }
+}
 
-        Int literal = stoll(words.at(3));
-        assert(literal != 0);
+void Cnf::mergeCnfChunk(CnfChunk& chunk, Int& lineIndex, Int& problemLineIndex, Int& declaredClauseCount) {
+  size_t clauseIndex = 0;
+  for (size_t i = 0; i < chunk.specialLines.size(); i++) {
+    for (; clauseIndex < chunk.specialClauseCounts.at(i); clauseIndex++) {
+      xorClauseCount += chunk.clauses.xorFlags.at(clauseIndex);
+      clauses.append(chunk.clauses.at(clauseIndex));
+    }
+    readCnfLine(string(chunk.specialLines.at(i)), lineIndex + chunk.specialLineIndices.at(i), problemLineIndex, declaredClauseCount);
+  }
+  for (; clauseIndex < chunk.clauses.size(); clauseIndex++) {
+    xorClauseCount += chunk.clauses.xorFlags.at(clauseIndex);
+    clauses.append(chunk.clauses.at(clauseIndex));
+  }
+  lineIndex += chunk.lineCount;
+  chunk.clauses = ClauseList(); // frees memory early
+}
+
+void Cnf::readCompressedCnfChunks(const string& decompressor, const InputBuffer& inputBuffer, const string& filePath, Int& lineIndex, Int& problemLineIndex, Int& declaredClauseCount) {
+  DecompressionPipe decompressionPipe(decompressor, inputBuffer, filePath);
+
+  struct ParsedChunk {
+    string text; // outlives special lines of chunk
+    CnfChunk chunk;
+    thread parser;
+  };
+  std::deque<ParsedChunk> parsedChunks; // in file order; deque keeps elements in place for parser threads
+  size_t parserLimit = max(thread::hardware_concurrency(), 1u);
+  auto mergeFrontChunk = [&]() {
+    parsedChunks.front().parser.join();
+    mergeCnfChunk(parsedChunks.front().chunk, lineIndex, problemLineIndex, declaredClauseCount);
+    parsedChunks.pop_front();
+  };
+
+  string pendingText; // decompressed lines not yet handed to parser
+  size_t headerOffset = 0; // comment lines before it have been scanned for problem line
+  bool headerFlag = false;
+  Int fastVarCount = -1;
+  char block[1 << 16];
+  try {
+    for (bool endFlag = false; !endFlag;) {
+      size_t byteCount = decompressionPipe.read(block, sizeof(block));
+      endFlag = byteCount == 0;
+      pendingText.append(block, byteCount);
+      if (!endFlag && pendingText.size() < CNF_CHUNK_SIZE) {
+        continue;
+      }
 
-        if (abs(literal) > declaredVarCount) {
-          throw MyError("literal '", literal, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
+      size_t chunkSize = endFlag ? pendingText.size() : pendingText.rfind('\n') + 1; // 0 if no line is complete yet
+      if (!headerFlag) { // chunks are parsed only once problem line decides fast parsing
+        const char* lineBegin = pendingText.data() + headerOffset;
+        headerFlag = CnfChunk::findProblemLine(lineBegin, pendingText.data() + chunkSize, fastVarCount) || endFlag;
+        headerOffset = lineBegin - pendingText.data();
+        if (!headerFlag) {
+          continue;
         }
+      }
+      if (chunkSize == 0) {
+        continue;
+      }
 
-        Number weight(words.at(4));
-        if (weight < Number()) {
-          cout << WARNING << "literal weight is negative | line " << lineIndex << ": " << line << "\n";
-          // throw MyError("literal weight must be non-negative | line ", lineIndex);
-        }
-        literalWeights[literal] = weight;
+      if (parsedChunks.size() >= parserLimit) {
+        mergeFrontChunk();
       }
+      ParsedChunk& parsedChunk = parsedChunks.emplace_back();
+      parsedChunk.text = std::move(pendingText);
+      pendingText = parsedChunk.text.substr(chunkSize); // partial last line
+      parsedChunk.text.resize(chunkSize);
+      parsedChunk.parser = thread(&CnfChunk::parseLines, &parsedChunk.chunk, parsedChunk.text.data(), parsedChunk.text.data() + chunkSize, fastVarCount, verboseCnf < 3);
     }
-    else if (!frontWord.starts_with("c")) { // clause line
-      if (problemLineIndex == MIN_INT) {
-        throw MyError("no problem line before clause | line ", lineIndex);
+    while (!parsedChunks.empty()) {
+      mergeFrontChunk();
+    }
+  }
+  catch (...) { // parser threads must be joined before they are destroyed
+    for (ParsedChunk& parsedChunk : parsedChunks) {
+      if (parsedChunk.parser.joinable()) {
+        parsedChunk.parser.join();
       }
+    }
+    throw;
+  }
 
-      bool xorFlag = false;
-      if (frontWord.starts_with("x")) {
-        xorFlag = true;
-        xorClauseCount++;
+  decompressionPipe.finish();
+}
 
-        if (frontWord == "x") {
-          words.erase(words.begin());
-        }
-        else {
-          frontWord.erase(frontWord.begin());
-        }
-      }
-      Clause clause(xorFlag);
+void Cnf::readCnfFile(const string& filePath) {
+  cout << "c processing CNF formula...\n";
 
-      for (Int i = 0; i < words.size(); i++) {
-        Int num = stoll(words.at(i));
+  Int declaredClauseCount = MIN_INT;
 
-        if (abs(num) > declaredVarCount) {
-          throw MyError("literal '", num, "' inconsistent with declared var count '", declaredVarCount, "' | line ", lineIndex);
-        }
+  Int lineIndex = 0;
+  Int problemLineIndex = MIN_INT;
 
-        if (num == 0) {
-          if (i != words.size() - 1) {
-            throw MyError("clause terminated prematurely by '0' | line ", lineIndex);
-          }
+  InputBuffer inputBuffer(filePath);
+  string decompressor = inputBuffer.getDecompressor();
+  if (!decompressor.empty()) { // decompressed text is never held whole
+    readCompressedCnfChunks(decompressor, inputBuffer, filePath, lineIndex, problemLineIndex, declaredClauseCount);
+  }
+  else {
+    const char* bufferEnd = inputBuffer.data + inputBuffer.size;
+
+    Int fastVarCount = -1; // from problem line if it precedes every clause line; else all lines are read sequentially
+    const char* headerEnd = inputBuffer.data;
+    CnfChunk::findProblemLine(headerEnd, bufferEnd, fastVarCount);
+
+    Int chunkCount = min(max(static_cast<Int>(thread::hardware_concurrency()), 1ll), static_cast<Int>(inputBuffer.size / CNF_CHUNK_SIZE) + 1);
+    vector<const char*> chunkBegins = {inputBuffer.data};
+    for (Int chunkIndex = 1; chunkIndex < chunkCount; chunkIndex++) { // splits at line boundaries
+      const char* p = inputBuffer.data + inputBuffer.size * chunkIndex / chunkCount;
+      p = max(p, chunkBegins.back());
+      const char* lineEnd = static_cast<const char*>(memchr(p, '\n', bufferEnd - p));
+      chunkBegins.push_back(lineEnd == nullptr ? bufferEnd : lineEnd + 1);
+    }
+    chunkBegins.push_back(bufferEnd);
 
-          if (clause.empty()) {
-            throw EmptyClauseException(lineIndex, line);
-          }
+    vector<CnfChunk> chunks(chunkCount);
+    vector<thread> threads;
+    for (Int chunkIndex = 1; chunkIndex < chunkCount; chunkIndex++) {
+      threads.push_back(thread(&CnfChunk::parseLines, &chunks.at(chunkIndex), chunkBegins.at(chunkIndex), chunkBegins.at(chunkIndex + 1), fastVarCount, verboseCnf < 3));
+    }
+    chunks.front().parseLines(chunkBegins.at(0), chunkBegins.at(1), fastVarCount, verboseCnf < 3);
+    for (thread& t : threads) {
+      t.join();
+    }
 
-          addClause(clause);
-        }
-        else { // literal
-          if (i == words.size() - 1) {
-            throw MyError("missing end-of-clause indicator '0' | line ", lineIndex);
-          }
-          clause.insertLiteral(num);
-        }
-      }
+    for (CnfChunk& chunk : chunks) { // merges in file order
+      mergeCnfChunk(chunk, lineIndex, problemLineIndex, declaredClauseCount);
     }
   }
 
@@ -891,6 +1406,12 @@ Assignment::Assignment(const string& bitString) {
   }
 }
 
+Assignment::Assignment(const vector<Int>& vars, Int bits) {
+  for (Int i = vars.size() - 1; i >= 0; i--, bits >>= 1) {
+    insert({vars.at(i), bits & 1});
+  }
+}
+
 bool Assignment::getValue(Int var) const {
   auto it = find(var);
   return (it != end()) ? it->second : true;
@@ -905,23 +1426,6 @@ void Assignment::printAssignment() const {
   }
 }
 
-vector<Assignment> Assignment::getExtendedAssignments(const vector<Assignment>& assignments, Int var) {
-  vector<Assignment> extendedAssignments;
-  if (assignments.empty()) {
-    extendedAssignments.push_back(Assignment(var, false));
-    extendedAssignments.push_back(Assignment(var, true));
-  }
-  else {
-    for (Assignment assignment : assignments) {
-      assignment[var] = false;
-      extendedAssignments.push_back(assignment);
-      assignment[var] = true;
-      extendedAssignments.push_back(assignment);
-    }
-  }
-  return extendedAssignments;
-}
-
 /* class JoinNode =========================================================== */
 
 Int JoinNode::nodeCount;
@@ -950,8 +1454,28 @@ void JoinNode::restoreStaticFields() {
   nonterminalIndices = backupNonterminalIndices;
 }
 
-Set<Int> JoinNode::getPostProjectionVars() const {
-  return util::getDiff(preProjectionVars, projectionVars);
+Int JoinNode::getWidth(const Assignment& assignment) const {
+  Int width = 0;
+  visitPostOrder([&](const JoinNode* node) {
+    Int unassignedVarCount = 0;
+    for (Int var : node->preProjectionVars) {
+      unassignedVarCount += !assignment.contains(var);
+    }
+    width = max(width, unassignedVarCount);
+  });
+  return width;
+}
+
+void JoinNode::updateVarSizes(Map<Int, size_t>& varSizes) const {
+  visitPostOrder([&](const JoinNode* node) {
+    for (Int var : node->preProjectionVars) { // clause vars for JoinTerminal
+      varSizes[var] = max(varSizes[var], node->preProjectionVars.size());
+    }
+  });
+}
+
+vector<Int> JoinNode::getPostProjectionVars() const {
+  return util::getSortedDiff(preProjectionVars, projectionVars);
 }
 
 Int JoinNode::chooseClusterIndex(Int clusterIndex, const vector<Set<Int>>& projectableVarSets, string clusteringHeuristic) {
@@ -960,8 +1484,8 @@ Int JoinNode::chooseClusterIndex(Int clusterIndex, const vector<Set<Int>>& proje
   }
 
   Set<Int> projectableVars = util::getUnion(projectableVarSets); // Z = Z_1 \cup .. \cup Z_m
-  Set<Int> postProjectionVars = getPostProjectionVars(); // of this node
-  if (util::isDisjoint(projectableVars, postProjectionVars)) {
+  vector<Int> postProjectionVars = getPostProjectionVars(); // of this node
+  if (util::isDisjoint(postProjectionVars, projectableVars)) {
     return projectableVarSets.size(); // special cluster
   }
 
@@ -977,12 +1501,12 @@ Int JoinNode::chooseClusterIndex(Int clusterIndex, const vector<Set<Int>>& proje
 }
 
 Int JoinNode::getNodeRank(const vector<Int>& restrictedVarOrder, string clusteringHeuristic) {
-  Set<Int> postProjectionVars = getPostProjectionVars();
+  vector<Int> postProjectionVars = getPostProjectionVars();
 
   if (clusteringHeuristic == BUCKET_ELIM_LIST || clusteringHeuristic == BUCKET_ELIM_TREE) { // min var rank
     Int rank = MAX_INT;
     for (Int varRank = 0; varRank < restrictedVarOrder.size(); varRank++) {
-      if (postProjectionVars.contains(restrictedVarOrder.at(varRank))) {
+      if (util::isSortedMember(postProjectionVars, restrictedVarOrder.at(varRank))) {
         rank = min(rank, varRank);
       }
     }
@@ -991,7 +1515,7 @@ Int JoinNode::getNodeRank(const vector<Int>& restrictedVarOrder, string clusteri
 
   Int rank = MIN_INT;
   for (Int varRank = 0; varRank < restrictedVarOrder.size(); varRank++) {
-    if (postProjectionVars.contains(restrictedVarOrder.at(varRank))) {
+    if (util::isSortedMember(postProjectionVars, restrictedVarOrder.at(varRank))) {
       rank = max(rank, varRank);
     }
   }
@@ -1004,23 +1528,12 @@ bool JoinNode::isTerminal() const {
 
 /* class JoinTerminal ======================================================= */
 
-Int JoinTerminal::getWidth(const Assignment& assignment) const {
-  return util::getDiff(preProjectionVars, assignment).size();
-}
-
-void JoinTerminal::updateVarSizes(Map<Int, size_t>& varSizes) const {
-  Set<Int> vars = cnf.clauses.at(nodeIndex).getClauseVars();
-  for (Int var : vars) {
-    varSizes[var] = max(varSizes[var], vars.size());
-  }
-}
-
 JoinTerminal::JoinTerminal() {
   nodeIndex = terminalCount;
   terminalCount++;
   nodeCount++;
 
-  preProjectionVars = cnf.clauses.at(nodeIndex).getClauseVars();
+  preProjectionVars = util::getSortedNums(cnf.clauses.at(nodeIndex).getClauseVars());
 }
 
 /* class JoinNonterminal ===================================================== */
@@ -1041,31 +1554,37 @@ void JoinNonterminal::printNode(const string& startWord) const {
 }
 
 void JoinNonterminal::printSubtree(const string& startWord) const {
-  for (const JoinNode* child : children) {
-    if (!child->isTerminal()) {
-      static_cast<const JoinNonterminal*>(child)->printSubtree(startWord);
+  visitPostOrder([&](const JoinNode* node) {
+    if (!node->isTerminal()) {
+      static_cast<const JoinNonterminal*>(node)->printNode(startWord);
     }
-  }
-  printNode(startWord);
+  });
 }
 
-Int JoinNonterminal::getWidth(const Assignment& assignment) const {
-  Int width = util::getDiff(preProjectionVars, assignment).size();
-  for (JoinNode* child : children) {
-    width = max(width, child->getWidth(assignment));
-  }
-  return width;
-}
+void JoinNonterminal::writeNode(string& bytes) const {
+  util::writeVarint(bytes, nodeIndex);
 
-void JoinNonterminal::updateVarSizes(Map<Int, size_t>& varSizes) const {
-  for (Int var : preProjectionVars) {
-    varSizes[var] = max(varSizes[var], preProjectionVars.size());
+  util::writeVarint(bytes, children.size());
+  for (const JoinNode* child : children) {
+    util::writeVarint(bytes, nodeIndex - child->nodeIndex); // positive since children precede parent
   }
-  for (JoinNode* child : children) {
-    child->updateVarSizes(varSizes);
+
+  util::writeVarint(bytes, projectionVars.size());
+  Int prevVar = 0;
+  for (Int var : projectionVars) {
+    util::writeVarint(bytes, var - prevVar);
+    prevVar = var;
   }
 }
 
+void JoinNonterminal::writeSubtree(string& bytes) const {
+  visitPostOrder([&](const JoinNode* node) {
+    if (!node->isTerminal()) {
+      static_cast<const JoinNonterminal*>(node)->writeNode(bytes);
+    }
+  });
+}
+
 vector<Int> JoinNonterminal::getBiggestNodeVarOrder() const {
   Map<Int, size_t> varSizes; // var x |-> size of biggest node containing x
   for (Int var : cnf.apparentVars) {
@@ -1147,9 +1666,9 @@ vector<Int> JoinNonterminal::getVarOrder(Int varOrderHeuristic) const {
   return varOrder;
 }
 
-vector<Assignment> JoinNonterminal::getOuterAssignments(Int varOrderHeuristic, Int sliceVarCount) const {
+vector<Int> JoinNonterminal::getSliceVars(Int varOrderHeuristic, Int sliceVarCount) const {
   if (sliceVarCount <= 0) {
-    return {Assignment()};
+    return {};
   }
 
   TimePoint sliceVarOrderStartPoint = util::getTimePoint();
@@ -1158,18 +1677,16 @@ vector<Assignment> JoinNonterminal::getOuterAssignments(Int varOrderHeuristic, I
     util::printRow("sliceVarSeconds", util::getDuration(sliceVarOrderStartPoint));
   }
 
-  TimePoint assignmentsStartPoint = util::getTimePoint();
-  vector<Assignment> assignments;
+  vector<Int> sliceVars;
 
   if (verboseSolving >= 2) {
     cout << "c slice var order heuristic: {";
   }
 
-  for (Int i = 0, assignedVars = 0; i < varOrder.size() && assignedVars < sliceVarCount; i++) {
+  for (size_t i = 0; i < varOrder.size() && static_cast<Int>(sliceVars.size()) < sliceVarCount; i++) {
     Int var = varOrder.at(i);
     if (cnf.outerVars.contains(var)) {
-      assignments = Assignment::getExtendedAssignments(assignments, var);
-      assignedVars++;
+      sliceVars.push_back(var);
       if (verboseSolving >= 2) {
         cout << " " << var;
       }
@@ -1180,16 +1697,12 @@ vector<Assignment> JoinNonterminal::getOuterAssignments(Int varOrderHeuristic, I
     cout << " }\n";
   }
 
-  if (verboseSolving >= 1) {
-    util::printRow("sliceAssignmentsSeconds", util::getDuration(assignmentsStartPoint));
-  }
-
-  return assignments;
+  return sliceVars;
 }
 
 JoinNonterminal::JoinNonterminal(const vector<JoinNode*>& children, const Set<Int>& projectionVars, Int requestedNodeIndex) {
   this->children = children;
-  this->projectionVars = projectionVars;
+  this->projectionVars = util::getSortedNums(projectionVars);
 
   if (requestedNodeIndex == MIN_INT) {
     requestedNodeIndex = nodeCount;
@@ -1206,8 +1719,21 @@ JoinNonterminal::JoinNonterminal(const vector<JoinNode*>& children, const Set<In
   nodeCount++;
 
   for (JoinNode* child : children) {
-    util::unionize(preProjectionVars, child->getPostProjectionVars());
+    vector<Int> childVars = child->getPostProjectionVars();
+    preProjectionVars.insert(preProjectionVars.end(), childVars.begin(), childVars.end());
   }
+  sort(preProjectionVars.begin(), preProjectionVars.end());
+  preProjectionVars.erase(unique(preProjectionVars.begin(), preProjectionVars.end()), preProjectionVars.end());
+}
+
+/* class JoinNodeArena ====================================================== */
+
+JoinTerminal* JoinNodeArena::newTerminal() {
+  return &joinTerminals.emplace_back();
+}
+
+JoinNonterminal* JoinNodeArena::newNonterminal(const vector<JoinNode*>& children, const Set<Int>& projectionVars, Int requestedNodeIndex) {
+  return &joinNonterminals.emplace_back(children, projectionVars, requestedNodeIndex);
 }
 
 /* global functions ========================================================= */
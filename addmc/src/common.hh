@@ -2,17 +2,35 @@
 
 /* inclusions =============================================================== */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <list>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <random>
+#include <set>
 #include <signal.h>
+#include <spawn.h>
+#include <span>
+#include <sstream>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/wait.h>
 #include <thread>
+#include <unistd.h>
 #include <unordered_set>
 
 #include <gmpxx.h>
@@ -61,9 +79,18 @@ const Int MIN_INT = std::numeric_limits<Int>::min();
 const Int MAX_INT = std::numeric_limits<Int>::max();
 
 const string JOIN_TREE_WORD = "jt";
+const string BINARY_JOIN_TREE_WORD = "jtb"; // problem line 'p jtb <version> <vars> <clauses> <nodes> <bytes>' is followed by raw bytes
+const Int BINARY_JOIN_TREE_VERSION = 1;
 const string ELIM_VARS_WORD = "e";
 
 const string WARNING = "c MY_WARNING: ";
+
+const size_t CNF_CHUNK_SIZE = 1 << 20; // min bytes per parsing thread
+const vector<pair<string, string>> COMPRESSION_MAGICS = { // leading bytes of compressed file, decompressor in PATH
+  {"\x1f\x8b", "gzip"},
+  {string("\xfd" "7zXZ\0", 6), "xz"},
+  {"\x28\xb5\x2f\xfd", "zstd"}
+};
 const string DASH_LINE = "c ------------------------------------------------------------------\n";
 
 const string CNF_FILE_OPTION = "cf";
@@ -146,6 +173,8 @@ namespace util {
   Float getDuration(TimePoint start); // in seconds
 
   vector<string> splitInputLine(const string& line);
+  void writeVarint(string& bytes, Int num); // unsigned LEB128, num >= 0
+  bool readVarint(const string& bytes, size_t& pos, Int& num); // false if bytes end early or num overflows
   void printInputLine(const string& line, Int lineIndex);
 
   void printRowKey(const string& key, size_t keyWidth);
@@ -207,14 +236,24 @@ namespace util {
     return s;
   }
 
-  template<typename T> bool isDisjoint(const Set<T>& container1, const Set<T>& container2) {
-    for (const T& member : container1) {
+  template<typename T, typename U> bool isDisjoint(const T& container1, const U& container2) { // container2 has `contains`
+    for (const auto& member : container1) {
       if (container2.contains(member)) {
         return false;
       }
     }
     return true;
   }
+
+  template<typename T> bool isSortedMember(const vector<T>& sortedNums, const T& num) {
+    return std::binary_search(sortedNums.begin(), sortedNums.end(), num);
+  }
+
+  template<typename T> vector<T> getSortedDiff(const vector<T>& sortedMembers, const vector<T>& sortedNonMembers) {
+    vector<T> diff;
+    std::set_difference(sortedMembers.begin(), sortedMembers.end(), sortedNonMembers.begin(), sortedNonMembers.end(), back_inserter(diff));
+    return diff;
+  }
 }
 
 /* classes for exceptions =================================================== */
@@ -254,6 +293,7 @@ public:
   Number(Float f); // !multiplePrecision
   Number(const Number& n);
   Number(const string& repr = "0"); // `repr` is `<int>/<int>` or `<float>`
+  Number& operator=(const Number& n);
 
   Number getAbsolute() const;
   Float getLog10() const;
@@ -294,16 +334,106 @@ public:
   static bool hasSmallerLabel(const pair<Int, Label>& a, const pair <Int, Label>& b);
 };
 
-class Clause : public Set<Int> {
+class Clause { // view of distinct literals in ClauseList
 public:
+  const Int* literalsBegin;
+  const Int* literalsEnd;
+  const Int* sortedLiteralsBegin; // same literals, sorted for contains
   bool xorFlag;
 
-  Clause(bool xorFlag);
+  Clause(const Int* literalsBegin, const Int* literalsEnd, const Int* sortedLiteralsBegin, bool xorFlag);
 
-  void insertLiteral(Int literal);
+  const Int* begin() const;
+  const Int* end() const;
+  size_t size() const;
+  bool empty() const;
+  bool contains(Int literal) const;
 
   void printClause() const;
   Set<Int> getClauseVars() const;
+
+  static void normalizeLiterals(vector<Int>& literals, bool xorFlag); // drops repeated literals, or cancels pairs in XOR clause; keeps order of hashed clause
+};
+
+class ClauseList;
+
+class ClauseIterator { // yields Clause views
+public:
+  const ClauseList* clauseList;
+  Int clauseIndex;
+
+  Clause operator*() const;
+  ClauseIterator& operator++();
+  bool operator!=(const ClauseIterator& it) const;
+};
+
+class ClauseList { // one contiguous literal array with offsets (CSR) instead of one hash set per clause
+public:
+  vector<Int> literals;
+  vector<Int> offsets = {0}; // clause i has literals [offsets[i], offsets[i + 1])
+  vector<Int> sortedLiterals; // same offsets
+  vector<bool> xorFlags;
+
+  size_t size() const;
+  bool empty() const;
+  Clause at(Int clauseIndex) const; // invalidated by next append
+  ClauseIterator begin() const;
+  ClauseIterator end() const;
+
+  void append(const Clause& clause);
+  void append(const vector<Int>& normalizedLiterals, bool xorFlag);
+};
+
+class InputBuffer { // whole file in memory: mapped if regular, read otherwise (e.g. pipe)
+public:
+  const char* data = nullptr;
+  size_t size = 0;
+  void* mappedData = nullptr;
+  string readData;
+
+  InputBuffer(const string& filePath);
+  InputBuffer(const InputBuffer&) = delete;
+  InputBuffer& operator=(const InputBuffer&) = delete;
+  ~InputBuffer();
+
+  string getDecompressor() const; // empty if data has no known magic number
+
+protected:
+  void releaseMap();
+};
+
+class DecompressionPipe { // runs '<decompressor> -dc' on compressed buffer; output is read as it is produced
+public:
+  DecompressionPipe(const string& decompressor, const InputBuffer& inputBuffer, const string& filePath); // inputBuffer must outlive *this
+  DecompressionPipe(const DecompressionPipe&) = delete;
+  DecompressionPipe& operator=(const DecompressionPipe&) = delete;
+  ~DecompressionPipe(); // stops decompressor if output was not read to end
+
+  size_t read(char* block, size_t capacity); // 0 at end of output
+  void finish(); // throws if decompressor failed
+
+protected:
+  string decompressor;
+  string filePath;
+  pid_t pid = -1;
+  int outFd = -1; // read end of decompressor stdout
+  std::thread feeder; // writes compressed bytes to decompressor stdin
+  sighandler_t oldSigpipeHandler = SIG_DFL;
+
+  int stop(); // closes pipes and reaps decompressor; returns wait status
+};
+
+class CnfChunk { // lines of CNF file parsed by one thread
+public:
+  ClauseList clauses; // from well-formed clause lines
+  vector<std::string_view> specialLines; // any other line that may matter, for sequential Cnf::readCnfLine
+  vector<Int> specialLineIndices; // in chunk; 1-indexing
+  vector<size_t> specialClauseCounts; // clauses before special line
+  Int lineCount = 0;
+
+  static bool parseInt(const char*& p, const char* end, Int& num); // like stoll but rejects what it cannot read exactly
+  static bool findProblemLine(const char*& lineBegin, const char* end, Int& fastVarCount); // skips comment lines; false if complete lines ran out first
+  void parseLines(const char* begin, const char* end, Int declaredVarCount, bool fastFlag); // declaredVarCount < 0 or !fastFlag makes every line special
 };
 
 class Cnf {
@@ -311,11 +441,12 @@ public:
   Int declaredVarCount = 0;
   Set<Int> outerVars;
   Map<Int, Number> literalWeights; // for outer and inner vars
-  vector<Clause> clauses;
+  ClauseList clauses;
   Int xorClauseCount = 0;
 
   Set<Int> apparentVars; // as opposed to hidden vars that are declared but appear in no clause
-  Map<Int, Set<Int>> varToClauses; // apparent var |-> clause indices
+  vector<Int> varClauseOffsets; // CSR: var x has clause indices [varClauseOffsets[x], varClauseOffsets[x + 1]) in varClauseIndices
+  vector<Int> varClauseIndices;
 
   Set<Int> getInnerVars() const;
   Map<Int, Number> getUnprunableWeights() const;
@@ -324,8 +455,10 @@ public:
   void printLiteralWeights() const;
   void printClauses() const;
 
-  void addClause(const Clause& clause);
-  void setApparentVars();
+  std::span<const Int> getVarClauses(Int var) const; // clause indices; set by setApparentVars
+  Set<Int> getClauseVars() const; // iteration order ties var orders to clause order
+  void addClause(vector<Int> literals, bool xorFlag);
+  void setApparentVars(); // also builds var-to-clause index
   Graph getPrimalGraph() const;
   vector<Int> getRandomVarOrder() const;
   vector<Int> getDeclarationVarOrder() const;
@@ -345,7 +478,10 @@ public:
 
   void printStats() const;
 
-  void readCnfFile(const string& filePath);
+  void readCnfLine(const string& line, Int lineIndex, Int& problemLineIndex, Int& declaredClauseCount);
+  void mergeCnfChunk(CnfChunk& chunk, Int& lineIndex, Int& problemLineIndex, Int& declaredClauseCount); // frees chunk clauses
+  void readCompressedCnfChunks(const string& decompressor, const InputBuffer& inputBuffer, const string& filePath, Int& lineIndex, Int& problemLineIndex, Int& declaredClauseCount); // parses decompressed chunks while later ones are decompressed
+  void readCnfFile(const string& filePath); // parses chunks in parallel, then merges them in file order
 
   Cnf(); // empty conjunction
 };
@@ -357,13 +493,13 @@ public:
   Assignment();
   Assignment(Int var, bool val);
   Assignment(const string& bitString);
+  Assignment(const vector<Int>& vars, Int bits); // vars.front() gets most significant bit
 
   bool getValue(Int var) const; // returns `true` if `var` is unassigned
   void printAssignment() const;
-  static vector<Assignment> getExtendedAssignments(const vector<Assignment>& assignments, Int var);
 };
 
-class JoinNode { // abstract
+class JoinNode { // base of JoinTerminal and JoinNonterminal, which are owned by JoinNodeArena
 public:
   static Int nodeCount;
   static Int terminalCount;
@@ -377,19 +513,35 @@ public:
 
   Int nodeIndex = MIN_INT; // 0-indexing (equal to clauseIndex for JoinTerminal)
   vector<JoinNode*> children; // empty for JoinTerminal
-  Set<Int> projectionVars; // empty for JoinTerminal
-  Set<Int> preProjectionVars; // set by constructor
+  vector<Int> projectionVars; // sorted; empty for JoinTerminal
+  vector<Int> preProjectionVars; // sorted; set by constructor
 
   static void resetStaticFields(); // backs up and re-initializes static fields
   static void restoreStaticFields(); // from backup
 
-  virtual Int getWidth(const Assignment& assignment = Assignment()) const = 0; // of subtree
+  template<typename Visitor> void visitPostOrder(Visitor visitor) const { // children before parent; explicit stack since list trees are as deep as var count
+    vector<pair<const JoinNode*, Int>> stack = {{this, 0}}; // node, position of next child
+    while (!stack.empty()) {
+      auto& [node, position] = stack.back();
+      if (position < static_cast<Int>(node->children.size())) {
+        const JoinNode* child = node->children.at(position++);
+        stack.push_back({child, 0});
+      }
+      else {
+        const JoinNode* visitedNode = node;
+        stack.pop_back();
+        visitor(visitedNode);
+      }
+    }
+  }
+
+  Int getWidth(const Assignment& assignment = Assignment()) const; // of subtree
 
-  virtual void updateVarSizes(
-    Map<Int, size_t>& varSizes // var x |-> size of biggest node containing x
-  ) const = 0;
+  void updateVarSizes(
+    Map<Int, size_t>& varSizes // var x |-> size of biggest node containing x in subtree
+  ) const;
 
-  Set<Int> getPostProjectionVars() const;
+  vector<Int> getPostProjectionVars() const; // sorted
   Int chooseClusterIndex(
     Int clusterIndex, // of this node
     const vector<Set<Int>>& projectableVarSets, // Z_1, ..., Z_m
@@ -404,10 +556,6 @@ public:
 
 class JoinTerminal : public JoinNode {
 public:
-  Int getWidth(const Assignment& assignment = Assignment()) const override;
-
-  void updateVarSizes(Map<Int, size_t>& varSizes) const override;
-
   JoinTerminal();
 };
 
@@ -415,15 +563,14 @@ class JoinNonterminal : public JoinNode {
 public:
   void printNode(const string& startWord) const; // 1-indexing
   void printSubtree(const string& startWord = "") const; // post-order traversal
+  void writeNode(string& bytes) const; // varints: index, child count, child gaps, var count, var gaps
+  void writeSubtree(string& bytes) const; // post-order traversal
 
-  Int getWidth(const Assignment& assignment = Assignment()) const override;
-
-  void updateVarSizes(Map<Int, size_t>& varSizes) const override;
   vector<Int> getBiggestNodeVarOrder() const;
   vector<Int> getHighestNodeVarOrder() const;
   vector<Int> getVarOrder(Int varOrderHeuristic) const;
 
-  vector<Assignment> getOuterAssignments(Int varOrderHeuristic, Int sliceVarCount) const;
+  vector<Int> getSliceVars(Int varOrderHeuristic, Int sliceVarCount) const; // first outer vars in var order
 
   JoinNonterminal(
     const vector<JoinNode*>& children,
@@ -432,6 +579,19 @@ public:
   );
 };
 
+class JoinNodeArena { // owns join nodes of one tree; deques allocate them in blocks at stable addresses
+public:
+  std::deque<JoinTerminal> joinTerminals;
+  std::deque<JoinNonterminal> joinNonterminals;
+
+  JoinTerminal* newTerminal();
+  JoinNonterminal* newNonterminal(
+    const vector<JoinNode*>& children,
+    const Set<Int>& projectionVars = Set<Int>(),
+    Int requestedNodeIndex = MIN_INT
+  );
+};
+
 /* global functions ========================================================= */
 
 ostream& operator<<(ostream& stream, const Number& n);
@@ -0,0 +1,232 @@
+#include "dmc.hh" // ddbench.o links with dmc.cc compiled without main (see makefile)
+
+/* constants ================================================================ */
+
+const string FAMILY_OPTION = "fa";
+const string SIZE_OPTION = "sz";
+const string CLAUSE_WIDTH_OPTION = "cw";
+const string REPETITION_OPTION = "rp";
+
+/* families: */
+const string CHAIN_FAMILY = "chain";
+const string GRID_FAMILY = "grid";
+const string RANDOM_FAMILY = "random";
+const string CNF_FAMILY = "cnf";
+const map<string, string> FAMILIES = {
+  {CHAIN_FAMILY, "x_i | x_{i+1}"},
+  {GRID_FAMILY, "x_{i,j} | x_{i,j+1} and x_{i,j} | x_{i+1,j}"},
+  {RANDOM_FAMILY, "random k-CNF with 4n clauses"},
+  {CNF_FAMILY, "clauses captured from CNF file"}
+};
+
+/* global functions ========================================================= */
+
+void addBenchClause(const vector<Int>& literals) {
+  JoinNode::cnf.addClause(literals, false);
+}
+
+void setSyntheticCnf(const string& family, Int size, Int clauseWidth) {
+  Cnf& cnf = JoinNode::cnf;
+  if (family == CHAIN_FAMILY) {
+    cnf.declaredVarCount = size;
+    for (Int var = 1; var < size; var++) {
+      addBenchClause({var, var + 1});
+    }
+  }
+  else if (family == GRID_FAMILY) {
+    cnf.declaredVarCount = size * size;
+    auto getVar = [size](Int row, Int col) { return row * size + col + 1; };
+    for (Int row = 0; row < size; row++) {
+      for (Int col = 0; col < size; col++) {
+        if (col + 1 < size) {
+          addBenchClause({getVar(row, col), getVar(row, col + 1)});
+        }
+        if (row + 1 < size) {
+          addBenchClause({getVar(row, col), -getVar(row + 1, col)});
+        }
+      }
+    }
+  }
+  else { // RANDOM_FAMILY
+    cnf.declaredVarCount = size;
+    std::mt19937_64 generator(randomSeed);
+    std::uniform_int_distribution<Int> varDistribution(1, size);
+    std::bernoulli_distribution signDistribution;
+    for (Int clauseIndex = 0; clauseIndex < 4 * size; clauseIndex++) {
+      vector<Int> literals;
+      for (Int i = 0; i < clauseWidth; i++) {
+        Int var = varDistribution(generator);
+        literals.push_back(signDistribution(generator) ? var : -var);
+      }
+      addBenchClause(literals);
+    }
+  }
+
+  for (Int var = 1; var <= cnf.declaredVarCount; var++) {
+    cnf.outerVars.insert(var);
+    cnf.literalWeights[var] = Number("1/3");
+    cnf.literalWeights[-var] = Number("2/3");
+  }
+  cnf.setApparentVars();
+}
+
+Dd getClauseProduct(Int firstClause, Int lastClause, const vector<Int>& cnfVarToDdVar, const Cudd* mgr) { // clauses [firstClause, lastClause)
+  Dd dd = Dd::getOneDd(mgr);
+  for (Int clauseIndex = firstClause; clauseIndex < lastClause; clauseIndex++) {
+    Clause clause = JoinNode::cnf.clauses.at(clauseIndex);
+    vector<pair<Int, bool>> ddLiterals;
+    for (Int literal : clause) {
+      ddLiterals.push_back({cnfVarToDdVar.at(abs(literal)), literal > 0});
+    }
+    dd = dd.getProduct(Dd::getClauseDd(ddLiterals, clause.xorFlag, mgr));
+  }
+  return dd;
+}
+
+template<typename Op> void benchmarkOp(const string& name, Int repetitionCount, Op op) { // prints median seconds and result size
+  vector<Float> durations;
+  size_t nodeCount = 0;
+  for (Int repetition = 0; repetition < repetitionCount; repetition++) {
+    TimePoint startPoint = util::getTimePoint();
+    Dd dd = op();
+    durations.push_back(util::getDuration(startPoint));
+    nodeCount = dd.getNodeCount();
+  }
+  sort(durations.begin(), durations.end());
+  printRow(name + "Seconds", durations.at(durations.size() / 2));
+  printRow(name + "Nodes", nodeCount);
+}
+
+void runBenchmarks(Int repetitionCount) {
+  const Cudd* mgr = ddPackage == CUDD_PACKAGE ? Dd::newMgr(maxMem) : nullptr;
+
+  vector<Int> cnfVarToDdVar(JoinNode::cnf.declaredVarCount + 1, 0); // declaration order
+  vector<Int> ddVarToCnfVar;
+  for (Int cnfVar = 1; cnfVar <= JoinNode::cnf.declaredVarCount; cnfVar++) {
+    cnfVarToDdVar.at(cnfVar) = ddVarToCnfVar.size();
+    ddVarToCnfVar.push_back(cnfVar);
+  }
+  Dd::setDdVarWeights(ddVarToCnfVar);
+
+  { // DDs are released before manager
+    Int clauseCount = JoinNode::cnf.clauses.size();
+    TimePoint operandStartPoint = util::getTimePoint();
+    Dd leftDd = getClauseProduct(0, clauseCount / 2, cnfVarToDdVar, mgr);
+    Dd rightDd = getClauseProduct(clauseCount / 2, clauseCount, cnfVarToDdVar, mgr);
+    printRow("operandSeconds", util::getDuration(operandStartPoint));
+    printRow("leftNodes", leftDd.getNodeCount());
+    printRow("rightNodes", rightDd.getNodeCount());
+
+    Dd productDd = leftDd.getProduct(rightDd);
+    Set<Int> support = productDd.getSupport();
+    Int midDdVar = support.empty() ? 0 : *std::min_element(support.begin(), support.end()); // top var of product
+    vector<pair<Int, Dd>> maximizationStack;
+
+    benchmarkOp("product", repetitionCount, [&]() { return leftDd.getProduct(rightDd); });
+    benchmarkOp("sum", repetitionCount, [&]() { return leftDd.getSum(rightDd); });
+    benchmarkOp("max", repetitionCount, [&]() { return leftDd.getMax(rightDd); });
+    if (!logCounting) { // operands must be 0-1 DDs
+      benchmarkOp("xor", repetitionCount, [&]() { return leftDd.getXor(rightDd); });
+    }
+    benchmarkOp("composition", repetitionCount, [&]() { return productDd.getComposition(midDdVar, true, mgr); });
+    benchmarkOp("abstraction", repetitionCount, [&]() {
+      return productDd.getAbstraction(midDdVar, ddVarToCnfVar, JoinNode::cnf.literalWeights, Assignment(), true, maximizationStack, mgr);
+    });
+    vector<Int> supportDdVars(support.begin(), support.end());
+    benchmarkOp("cubeAbstraction", repetitionCount, [&]() { return productDd.getCubeAbstraction(supportDdVars, mgr); });
+    if (logCounting) {
+      Float median = productDd.getCubeAbstraction(supportDdVars, mgr).extractConst().fraction - log10l(2); // prunes roughly half
+      benchmarkOp("pruning", repetitionCount, [&]() { return productDd.getPrunedDd(median, mgr); });
+    }
+  }
+  Dd::releaseDdVarWeightLeaves();
+
+  if (ddPackage == CUDD_PACKAGE) {
+    delete mgr;
+  }
+}
+
+int main(int argc, char** argv) {
+  cout << std::unitbuf; // enables automatic flushing
+
+  cxxopts::Options options("ddbench", "Micro-benchmarks for diagram kernels of dmc");
+  options.set_width(125);
+
+  string helpFamily = "family: ";
+  for (auto it = FAMILIES.begin(); it != FAMILIES.end(); it++) {
+    helpFamily += it->first + " (" + it->second + ")" + (next(it) != FAMILIES.end() ? ", " : "");
+  }
+
+  using cxxopts::value;
+  options.add_options()
+    (FAMILY_OPTION, helpFamily + "; string", value<string>()->default_value(CHAIN_FAMILY))
+    (SIZE_OPTION, "size n of synthetic family; int", value<Int>()->default_value("100"))
+    (CLAUSE_WIDTH_OPTION, "clause width k of random family; int", value<Int>()->default_value("3"))
+    (CNF_FILE_OPTION, "CNF file path [needs fa_arg = cnf]; string", value<string>()->default_value(""))
+    (DD_PACKAGE_OPTION, "diagram package: c/CUDD, s/SYLVAN; string", value<string>()->default_value(CUDD_PACKAGE))
+    (LOG_COUNTING_OPTION, "logarithmic counting: 0, 1; int", value<Int>()->default_value("0"))
+    (MULTIPLE_PRECISION_OPTION, "multiple precision [needs dp_arg = s, lc_arg = 0]: 0, 1; int", value<Int>()->default_value("0"))
+    (MAX_MEM_OPTION, "maximum memory (in MB) for unique table and cache table combined; float", value<Float>()->default_value("4e3"))
+    (TABLE_RATIO_OPTION, "table ratio [needs dp_arg = s]: log2(unique_size/cache_size); int", value<Int>()->default_value("1"))
+    (INIT_RATIO_OPTION, "init ratio for tables [needs dp_arg = s]: log2(max_size/init_size); int", value<Int>()->default_value("10"))
+    (REPETITION_OPTION, "repetitions per kernel (median is printed); int", value<Int>()->default_value("5"))
+    (RANDOM_SEED_OPTION, "random seed; int", value<Int>()->default_value("0"))
+    (HELP_OPTION, "help")
+  ;
+
+  cxxopts::ParseResult result = options.parse(argc, argv);
+  if (result.count(HELP_OPTION)) {
+    cout << options.help();
+    return 0;
+  }
+
+  string family = result[FAMILY_OPTION].as<string>();
+  assert(FAMILIES.contains(family));
+  ddPackage = result[DD_PACKAGE_OPTION].as<string>(); // global var
+  assert(DD_PACKAGES.contains(ddPackage));
+  logCounting = result[LOG_COUNTING_OPTION].as<Int>(); // global var
+  multiplePrecision = result[MULTIPLE_PRECISION_OPTION].as<Int>(); // global var
+  assert(!multiplePrecision || (ddPackage == SYLVAN_PACKAGE && !logCounting));
+  maxMem = result[MAX_MEM_OPTION].as<Float>(); // global var
+  Int tableRatio = result[TABLE_RATIO_OPTION].as<Int>();
+  Int initRatio = result[INIT_RATIO_OPTION].as<Int>();
+  randomSeed = result[RANDOM_SEED_OPTION].as<Int>(); // global var
+  Int repetitionCount = max(result[REPETITION_OPTION].as<Int>(), 1ll);
+  weightedCountingMode = WeightedCountingMode::ALL_VARS; // global var
+  logBound = -INF; // global var
+  threadCount = 1; // global var
+  joinPriority = SMALLEST_PAIR; // global var
+
+  if (family == CNF_FAMILY) {
+    JoinNode::cnf.readCnfFile(result[CNF_FILE_OPTION].as<string>());
+  }
+  else {
+    setSyntheticCnf(family, result[SIZE_OPTION].as<Int>(), result[CLAUSE_WIDTH_OPTION].as<Int>());
+  }
+  printRow("family", family);
+  printRow("diagramPackage", DD_PACKAGES.at(ddPackage));
+  printRow("logCounting", logCounting);
+  printRow("multiplePrecision", multiplePrecision);
+  printRow("declaredVars", JoinNode::cnf.declaredVarCount);
+  printRow("clauses", JoinNode::cnf.clauses.size());
+
+  if (ddPackage == SYLVAN_PACKAGE) { // initializes Sylvan as in OptionDict::runCommand
+    lace_init(threadCount, 0);
+    lace_startup(0, NULL, NULL);
+    sylvan::sylvan_set_limits(maxMem * MEGA, tableRatio, initRatio);
+    sylvan::sylvan_init_package();
+    sylvan::sylvan_init_mtbdd();
+    if (multiplePrecision) {
+      sylvan::gmp_init();
+    }
+    weightedAndAbstractOpid = sylvan::cache_next_opid();
+    sylvan::sylvan_gc_hook_pregc(TASK(countGarbageCollection));
+  }
+
+  runBenchmarks(repetitionCount);
+
+  if (ddPackage == SYLVAN_PACKAGE) {
+    sylvan::sylvan_quit();
+    lace_exit();
+  }
+}
@@ -13,11 +13,19 @@ bool maximizerVerification;
 bool substitutionMaximization;
 Int threadCount;
 Int threadSliceCount;
+Float sliceDeadline;
+bool subtreeCaching;
 Float memSensitivity;
 Float maxMem;
 string joinPriority;
 Int verboseJoinTree;
 Int verboseProfiling;
+string profileFilePath;
+string traceFilePath;
+string checkpointFilePath;
+Float checkpointInterval;
+Float spillRatio;
+string spillDirPath;
 
 Int dotFileIndex = 1;
 
@@ -135,6 +143,14 @@ void JoinTreeProcessor::processCommentLine(const vector<string>& words) {
   }
 }
 
+void JoinTreeProcessor::initJoinTree(Int declaredVarCount, Int declaredClauseCount, Int declaredNodeCount) {
+  joinTree = new JoinTree(declaredVarCount, declaredClauseCount, declaredNodeCount);
+
+  for (Int terminalIndex = 0; terminalIndex < declaredClauseCount; terminalIndex++) {
+    joinTree->joinTerminals[terminalIndex] = joinTree->arena.newTerminal();
+  }
+}
+
 void JoinTreeProcessor::processProblemLine(const vector<string>& words) {
   if (problemLineIndex != MIN_INT) {
     throw MyError("multiple problem lines: ", problemLineIndex, " and ", lineIndex);
@@ -150,15 +166,7 @@ void JoinTreeProcessor::processProblemLine(const vector<string>& words) {
     throw MyError("expected '", JOIN_TREE_WORD, "'; found '", jtWord, "' | line ", lineIndex);
   }
 
-  Int declaredVarCount = stoll(words.at(2));
-  Int declaredClauseCount = stoll(words.at(3));
-  Int declaredNodeCount = stoll(words.at(4));
-
-  joinTree = new JoinTree(declaredVarCount, declaredClauseCount, declaredNodeCount);
-
-  for (Int terminalIndex = 0; terminalIndex < declaredClauseCount; terminalIndex++) {
-    joinTree->joinTerminals[terminalIndex] = new JoinTerminal();
-  }
+  initJoinTree(stoll(words.at(2)), stoll(words.at(3)), stoll(words.at(4)));
 }
 
 void JoinTreeProcessor::processNonterminalLine(const vector<string>& words) {
@@ -201,7 +209,74 @@ void JoinTreeProcessor::processNonterminalLine(const vector<string>& words) {
       }
     }
   }
-  joinTree->joinNonterminals[parentIndex] = new JoinNonterminal(children, projectionVars, parentIndex);
+  joinTree->joinNonterminals[parentIndex] = joinTree->arena.newNonterminal(children, projectionVars, parentIndex);
+}
+
+void JoinTreeProcessor::processBinaryProblemLine(const vector<string>& words) {
+  if (problemLineIndex != MIN_INT) {
+    throw MyError("multiple problem lines: ", problemLineIndex, " and ", lineIndex);
+  }
+  problemLineIndex = lineIndex;
+
+  if (words.size() != 7) {
+    throw MyError("binary problem line ", lineIndex, " has ", words.size(), " words (should be 7)");
+  }
+
+  Int version = stoll(words.at(2));
+  if (version != BINARY_JOIN_TREE_VERSION) {
+    throw MyError("binary join tree version ", version, " unsupported (expected ", BINARY_JOIN_TREE_VERSION, ") | line ", lineIndex);
+  }
+
+  initJoinTree(stoll(words.at(3)), stoll(words.at(4)), stoll(words.at(5)));
+
+  Int byteCount = stoll(words.at(6));
+  if (byteCount < 0) {
+    throw MyError("negative byte count | line ", lineIndex);
+  }
+  string bytes(byteCount, '\0');
+  if (!std::cin.read(bytes.data(), byteCount)) { // planner may be killed while writing
+    cout << WARNING << "binary join tree ends after " << std::cin.gcount() << " of " << byteCount << " bytes | line " << lineIndex << "\n";
+    problemLineIndex = MIN_INT;
+    delete joinTree;
+    joinTree = nullptr;
+    return;
+  }
+
+  size_t pos = 0;
+  auto readNum = [&]() {
+    Int num;
+    if (!util::readVarint(bytes, pos, num)) {
+      throw MyError("malformed varint at byte ", pos, " of binary join tree | line ", lineIndex);
+    }
+    return num;
+  };
+  while (pos < bytes.size()) {
+    Int parentIndex = readNum();
+    if (parentIndex < joinTree->declaredClauseCount || parentIndex >= joinTree->declaredNodeCount) {
+      throw MyError("wrong internal-node index ", parentIndex + 1, " in binary join tree | line ", lineIndex);
+    }
+
+    vector<JoinNode*> children;
+    for (Int childCount = readNum(); childCount > 0; childCount--) {
+      Int gap = readNum();
+      if (gap <= 0 || gap > parentIndex) {
+        throw MyError("child gap ", gap, " wrong for internal node ", parentIndex + 1, " in binary join tree | line ", lineIndex);
+      }
+      children.push_back(joinTree->getJoinNode(parentIndex - gap));
+    }
+
+    Set<Int> projectionVars;
+    Int var = 0;
+    for (Int varCount = readNum(); varCount > 0; varCount--) {
+      var += readNum();
+      if (var <= 0 || var > joinTree->declaredVarCount) {
+        throw MyError("var '", var, "' inconsistent with declared var count '", joinTree->declaredVarCount, "' in binary join tree | line ", lineIndex);
+      }
+      projectionVars.insert(var);
+    }
+
+    joinTree->joinNonterminals[parentIndex] = joinTree->arena.newNonterminal(children, projectionVars, parentIndex);
+  }
 }
 
 void JoinTreeProcessor::finishReadingJoinTree() {
@@ -210,6 +285,7 @@ void JoinTreeProcessor::finishReadingJoinTree() {
 
   if (nonterminalCount < expectedNonterminalCount) {
     cout << WARNING << "missing internal nodes (" << expectedNonterminalCount << " expected, " << nonterminalCount << " found) before current join tree ends on line " << lineIndex << "\n";
+    delete joinTree;
   }
   else {
     if (joinTree->width == MIN_INT) {
@@ -227,6 +303,7 @@ void JoinTreeProcessor::finishReadingJoinTree() {
     }
 
     joinTreeEndLineIndex = lineIndex;
+    delete backupJoinTree; // frees nodes of previous join tree
     backupJoinTree = joinTree;
     JoinNode::resetStaticFields();
   }
@@ -258,7 +335,12 @@ void JoinTreeProcessor::readInputStream() {
       processCommentLine(words);
     }
     else if (words.front() == "p") { // problem line
-      processProblemLine(words);
+      if (words.size() > 1 && words.at(1) == BINARY_JOIN_TREE_WORD) {
+        processBinaryProblemLine(words);
+      }
+      else {
+        processProblemLine(words);
+      }
     }
     else { // nonterminal-node line
       processNonterminalLine(words);
@@ -300,6 +382,102 @@ JoinTreeProcessor::JoinTreeProcessor(Float plannerWaitDuration) {
 
 /* classes for execution ==================================================== */
 
+/* class SliceDeadlineException ============================================= */
+
+SliceDeadlineException::SliceDeadlineException(const string& message) : message(message) {}
+
+const char* SliceDeadlineException::what() const noexcept {
+  return message.c_str();
+}
+
+/* class SliceQueue ========================================================= */
+
+bool SliceQueue::popSlice(Int threadIndex, Assignment& assignment) {
+  std::unique_lock<mutex> lock(queueMutex);
+  while (true) {
+    pair<Int, Int>& range = threadRanges.at(threadIndex);
+    if (range.first < range.second) {
+      Int sliceIndex = range.first++;
+      assignment = Assignment(sliceVars, sliceIndex ^ (sliceIndex >> 1)); // Gray code: consecutive slices differ in one var
+      break;
+    }
+
+    if (!splitSlices.empty()) {
+      assignment = splitSlices.front();
+      splitSlices.pop_front();
+      break;
+    }
+
+    auto victim = max_element(threadRanges.begin(), threadRanges.end(), [](const pair<Int, Int>& a, const pair<Int, Int>& b) {
+      return a.second - a.first < b.second - b.first;
+    });
+    Int remainingSliceCount = victim->second - victim->first;
+    if (remainingSliceCount > 0) { // steals upper half of biggest remaining range
+      range = {victim->first + remainingSliceCount / 2, victim->second};
+      victim->second = range.first;
+      continue;
+    }
+
+    if (activeSliceCount == 0) {
+      return false;
+    }
+    queueCondition.wait(lock); // running slices may still be split
+  }
+  activeSliceCount++;
+  return true;
+}
+
+void SliceQueue::finishSlice() {
+  const std::lock_guard<mutex> g(queueMutex);
+  activeSliceCount--;
+  if (activeSliceCount == 0) {
+    queueCondition.notify_all();
+  }
+}
+
+bool SliceQueue::isSplittable(const Assignment& assignment) const {
+  return assignment.size() < sliceVars.size() + splitVars.size();
+}
+
+void SliceQueue::splitSlice(const Assignment& assignment) {
+  Int splitVar = splitVars.at(assignment.size() - sliceVars.size());
+  Assignment lowAssignment = assignment;
+  lowAssignment[splitVar] = false;
+  Assignment highAssignment = assignment;
+  highAssignment[splitVar] = true;
+
+  const std::lock_guard<mutex> g(queueMutex);
+  splitSlices.push_back(lowAssignment);
+  splitSlices.push_back(highAssignment);
+  activeSliceCount--;
+  queueCondition.notify_all();
+}
+
+SliceQueue::SliceQueue(const vector<Int>& outerVars, Int sliceVarCount, Int threadCount) {
+  sliceVars = vector<Int>(outerVars.begin(), outerVars.begin() + sliceVarCount);
+  splitVars = vector<Int>(outerVars.begin() + sliceVarCount, outerVars.end());
+  sliceCount = exp2l(sliceVarCount);
+
+  Int remainingSliceCount = sliceCount;
+  Int remainingThreadCount = sliceDeadline > 0 ? threadCount : min(threadCount, sliceCount); // split slices may keep extra threads busy
+  while (remainingThreadCount > 0) {
+    Int threadSliceCount = ceill(static_cast<Float>(remainingSliceCount) / remainingThreadCount);
+    Int begin = sliceCount - remainingSliceCount;
+    threadRanges.push_back({begin, begin + threadSliceCount});
+    remainingSliceCount -= threadSliceCount;
+    remainingThreadCount--;
+  }
+  assert(remainingSliceCount == 0);
+
+  if (verboseSolving >= 1) {
+    cout << "c thread slice counts: { ";
+    for (const pair<Int, Int>& range : threadRanges) {
+      cout << range.second - range.first << " ";
+    }
+    cout << "}\n";
+  }
+}
+
 /* class SatSolver ========================================================== */
 
 bool SatSolver::checkSat(bool exceptionThrowing) {
@@ -370,6 +548,15 @@ size_t Dd::maxDdNodeCount;
 size_t Dd::prunedDdCount;
 Float Dd::pruningDuration;
 
+std::atomic<size_t> Dd::spilledDdCount(0);
+
+mutex Dd::statsMutex;
+
+vector<pair<Number, Number>> Dd::ddVarWeights;
+vector<bool> Dd::ddVarAdditiveFlags;
+vector<std::array<Dd, 3>> Dd::ddVarWeightLeaves;
+std::optional<Dd> Dd::zeroLeaf;
+
 size_t Dd::getLeafCount() const {
   if (ddPackage == CUDD_PACKAGE) {
     return cuadd.CountLeaves();
@@ -379,10 +566,21 @@ size_t Dd::getLeafCount() const {
 }
 
 size_t Dd::getNodeCount() const {
-  if (ddPackage == CUDD_PACKAGE) {
-    return cuadd.nodeCount();
+  size_t count = nodeCount.load(std::memory_order_relaxed);
+  if (count == 0) { // concurrent callers store same value
+    count = ddPackage == CUDD_PACKAGE ? cuadd.nodeCount() : mtbdd.NodeCount();
+    nodeCount.store(count, std::memory_order_relaxed);
   }
-  return mtbdd.NodeCount();
+  return count;
+}
+
+void Dd::updateMaxDdSizes() const {
+  size_t leafCount = getLeafCount();
+  size_t nodeCount = getNodeCount();
+
+  const std::lock_guard<mutex> g(statsMutex);
+  maxDdLeafCount = max(maxDdLeafCount, leafCount);
+  maxDdNodeCount = max(maxDdNodeCount, nodeCount);
 }
 
 Dd::Dd(const ADD& cuadd) {
@@ -395,16 +593,22 @@ Dd::Dd(const Mtbdd& mtbdd) {
   this->mtbdd = mtbdd;
 }
 
-Dd::Dd(const Dd& dd) {
-  if (ddPackage == CUDD_PACKAGE) {
-    *this = Dd(dd.cuadd);
-  }
-  else {
-    *this = Dd(dd.mtbdd);
-  }
+Dd::Dd(const Dd& dd) : cuadd(dd.cuadd), mtbdd(dd.mtbdd), nodeCount(dd.nodeCount.load(std::memory_order_relaxed)) {}
+
+Dd::Dd(Dd&& dd) : cuadd(std::move(dd.cuadd)), mtbdd(std::move(dd.mtbdd)), nodeCount(dd.nodeCount.load(std::memory_order_relaxed)) {}
 
-  maxDdLeafCount = max(maxDdLeafCount, getLeafCount());
-  maxDdNodeCount = max(maxDdNodeCount, getNodeCount());
+Dd& Dd::operator=(const Dd& dd) {
+  cuadd = dd.cuadd;
+  mtbdd = dd.mtbdd;
+  nodeCount.store(dd.nodeCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  return *this;
+}
+
+Dd& Dd::operator=(Dd&& dd) {
+  cuadd = std::move(dd.cuadd);
+  mtbdd = std::move(dd.mtbdd);
+  nodeCount.store(dd.nodeCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  return *this;
 }
 
 Number Dd::extractConst() const {
@@ -425,6 +629,9 @@ Dd Dd::getConstDd(const Number& n, const Cudd* mgr) {
   if (ddPackage == CUDD_PACKAGE) {
     return logCounting ? Dd(mgr->constant(n.getLog10())) : Dd(mgr->constant(n.fraction));
   }
+  if (logCounting) {
+    return Dd(Mtbdd::doubleTerminal(n.getLog10()));
+  }
   if (multiplePrecision) {
     mpq_t q; // C interface
     mpq_init(q);
@@ -477,26 +684,62 @@ const Cudd* Dd::newMgr(Float mem, Int threadIndex) {
   return mgr;
 }
 
-bool Dd::operator!=(const Dd& rightDd) const {
+void Dd::collectGarbage(const Cudd* mgr) {
+  assert(ddPackage == CUDD_PACKAGE);
+  cuddGarbageCollect(mgr->getManager(), 1);
+}
+
+size_t Dd::getMemInUse(const Cudd* mgr) {
   if (ddPackage == CUDD_PACKAGE) {
-    return cuadd != rightDd.cuadd;
+    return mgr->ReadMemoryInUse();
   }
-  return mtbdd != rightDd.mtbdd;
+  size_t filled;
+  size_t total;
+  sylvan_table_usage(&filled, &total);
+  return filled;
+}
+
+void Dd::setDdVarWeights(const vector<Int>& ddVarToCnfVarMap) {
+  ddVarWeights.clear();
+  ddVarAdditiveFlags.clear();
+  for (Int cnfVar : ddVarToCnfVarMap) {
+    ddVarWeights.push_back({JoinNode::cnf.literalWeights.at(cnfVar), JoinNode::cnf.literalWeights.at(-cnfVar)});
+    ddVarAdditiveFlags.push_back(JoinNode::cnf.outerVars.contains(cnfVar) != existRandom);
+  }
+
+  releaseDdVarWeightLeaves();
+  if (ddPackage == SYLVAN_PACKAGE) { // leaves are made once instead of in every step of weightedAndAbstractTask
+    for (Int ddVar = 0; ddVar < static_cast<Int>(ddVarWeights.size()); ddVar++) {
+      const pair<Number, Number>& weights = ddVarWeights.at(ddVar);
+      ddVarWeightLeaves.push_back({getConstDd(weights.first, nullptr), getConstDd(weights.second, nullptr), getConstDd(getAbsentVarWeight(ddVar), nullptr)});
+    }
+    zeroLeaf = getZeroDd(nullptr);
+  }
+}
+
+void Dd::releaseDdVarWeightLeaves() {
+  ddVarWeightLeaves.clear();
+  zeroLeaf.reset();
+}
+
+Number Dd::getAbsentVarWeight(Int ddVar) {
+  const pair<Number, Number>& weights = ddVarWeights.at(ddVar);
+  return ddVarAdditiveFlags.at(ddVar) ? weights.first + weights.second : max(weights.first, weights.second);
 }
 
-bool Dd::operator<(const Dd& rightDd) const {
-  if (joinPriority == SMALLEST_PAIR) { // top = rightmost = smallest
-    return getNodeCount() > rightDd.getNodeCount();
+bool Dd::operator!=(const Dd& rightDd) const {
+  if (ddPackage == CUDD_PACKAGE) {
+    return cuadd != rightDd.cuadd;
   }
-  return getNodeCount() < rightDd.getNodeCount();
+  return mtbdd != rightDd.mtbdd;
 }
 
 Dd Dd::getComposition(Int ddVar, bool val, const Cudd* mgr) const {
   if (ddPackage == CUDD_PACKAGE) {
-    if (util::isFound(ddVar, cuadd.SupportIndices())) {
-      return Dd(cuadd.Compose(val ? mgr->addOne() : mgr->addZero(), ddVar));
+    if (ddVar >= mgr->ReadSize()) { // var never created in manager, so DD does not depend on it; Compose would fail
+      return *this;
     }
-    return *this;
+    return Dd(cuadd.Compose(val ? mgr->addOne() : mgr->addZero(), ddVar));
   }
   sylvan::MtbddMap m;
   m.put(ddVar, val ? Mtbdd::mtbddOne() : Mtbdd::mtbddZero());
@@ -507,6 +750,10 @@ Dd Dd::getProduct(const Dd& dd) const {
   if (ddPackage == CUDD_PACKAGE) {
     return logCounting ? Dd(cuadd + dd.cuadd) : Dd(cuadd * dd.cuadd);
   }
+  if (logCounting) {
+    LACE_ME;
+    return Dd(Mtbdd(mtbdd_apply(mtbdd.GetMTBDD(), dd.mtbdd.GetMTBDD(), TASK(logProductOp))));
+  }
   if (multiplePrecision) {
     LACE_ME;
     return Dd(Mtbdd(gmp_times(mtbdd.GetMTBDD(), dd.mtbdd.GetMTBDD())));
@@ -518,6 +765,10 @@ Dd Dd::getSum(const Dd& dd) const {
   if (ddPackage == CUDD_PACKAGE) {
     return logCounting ? Dd(cuadd.LogSumExp(dd.cuadd)) : Dd(cuadd + dd.cuadd);
   }
+  if (logCounting) {
+    LACE_ME;
+    return Dd(Mtbdd(mtbdd_apply(mtbdd.GetMTBDD(), dd.mtbdd.GetMTBDD(), TASK(logSumExpOp))));
+  }
   if (multiplePrecision) {
     LACE_ME;
     return Dd(Mtbdd(gmp_plus(mtbdd.GetMTBDD(), dd.mtbdd.GetMTBDD())));
@@ -537,8 +788,78 @@ Dd Dd::getMax(const Dd& dd) const {
 }
 
 Dd Dd::getXor(const Dd& dd) const {
-  assert(ddPackage == CUDD_PACKAGE);
-  return logCounting ? Dd(cuadd.LogXor(dd.cuadd)) : Dd(cuadd.Xor(dd.cuadd));
+  if (ddPackage == CUDD_PACKAGE) {
+    return logCounting ? Dd(cuadd.LogXor(dd.cuadd)) : Dd(cuadd.Xor(dd.cuadd));
+  }
+  LACE_ME;
+  return Dd(Mtbdd(mtbdd_apply(mtbdd.GetMTBDD(), dd.mtbdd.GetMTBDD(), TASK(xorOp))));
+}
+
+Dd Dd::getNodeDd(Int ddVar, const Dd& highDd, const Dd& lowDd, const Cudd* mgr) {
+  if (ddPackage == CUDD_PACKAGE) {
+    DdNode* high = highDd.cuadd.getNode();
+    DdNode* low = lowDd.cuadd.getNode();
+    return high == low ? highDd : Dd(ADD(*mgr, cuddUniqueInter(mgr->getManager(), ddVar, high, low))); // ADD ctor checks for NULL
+  }
+  return Dd(Mtbdd(mtbdd_makenode(ddVar, lowDd.mtbdd.GetMTBDD(), highDd.mtbdd.GetMTBDD())));
+}
+
+Dd Dd::getParityDd(vector<Int> ddVars, bool parity, const Cudd* mgr) {
+  sort(ddVars.begin(), ddVars.end(), greater<Int>()); // builds bottom-up
+
+  Dd evenDd = parity ? getZeroDd(mgr) : getOneDd(mgr); // XOR(vars below) == parity
+  Dd oddDd = parity ? getOneDd(mgr) : getZeroDd(mgr); // XOR(vars below) != parity
+  for (Int ddVar : ddVars) {
+    Dd nextEvenDd = getNodeDd(ddVar, oddDd, evenDd, mgr);
+    oddDd = getNodeDd(ddVar, evenDd, oddDd, mgr);
+    evenDd = nextEvenDd;
+  }
+  return evenDd;
+}
+
+Dd Dd::getClauseDd(vector<pair<Int, bool>> ddLiterals, bool xorFlag, const Cudd* mgr) {
+  if (xorFlag) {
+    bool parity = true; // XOR(vars) must equal parity
+    Set<Int> ddVars;
+    for (const pair<Int, bool>& ddLiteral : ddLiterals) {
+      if (!ddLiteral.second) {
+        parity = !parity;
+      }
+      if (!ddVars.erase(ddLiteral.first)) { // var occurring twice cancels out
+        ddVars.insert(ddLiteral.first);
+      }
+    }
+    return getParityDd(vector<Int>(ddVars.begin(), ddVars.end()), parity, mgr);
+  }
+
+  sort(ddLiterals.begin(), ddLiterals.end(), greater<pair<Int, bool>>()); // builds bottom-up
+  Dd clauseDd = getZeroDd(mgr); // disjunction of literals below
+  for (size_t i = 0; i < ddLiterals.size(); i++) {
+    auto [ddVar, val] = ddLiterals.at(i);
+    if (i > 0 && ddLiterals.at(i - 1).first == ddVar) {
+      if (ddLiterals.at(i - 1).second != val) { // tautology
+        return getOneDd(mgr);
+      }
+      continue; // duplicate literal
+    }
+    clauseDd = val ? getNodeDd(ddVar, getOneDd(mgr), clauseDd, mgr) : getNodeDd(ddVar, clauseDd, getOneDd(mgr), mgr);
+  }
+  return clauseDd;
+}
+
+Dd Dd::getCofactor(const Map<Int, bool>& ddVarAssignment, const Cudd* mgr) const {
+  if (ddPackage == CUDD_PACKAGE) {
+    ADD cube = mgr->addOne();
+    for (auto [ddVar, val] : ddVarAssignment) {
+      cube *= val ? mgr->addVar(ddVar) : mgr->addVar(ddVar).Cmpl(); // 0-1 ADD even if logCounting
+    }
+    return Dd(cuadd.Cofactor(cube));
+  }
+  sylvan::MtbddMap m;
+  for (auto [ddVar, val] : ddVarAssignment) {
+    m.put(ddVar, val ? Mtbdd::mtbddOne() : Mtbdd::mtbddZero());
+  }
+  return Dd(mtbdd.Compose(m));
 }
 
 Set<Int> Dd::getSupport() const {
@@ -559,14 +880,25 @@ Set<Int> Dd::getSupport() const {
 }
 
 Dd Dd::getBoolDiff(const Dd& rightDd) const {
-  assert(ddPackage == CUDD_PACKAGE);
-  return Dd((cuadd - rightDd.cuadd).BddThreshold(0).Add());
+  if (ddPackage == CUDD_PACKAGE) {
+    return Dd((cuadd - rightDd.cuadd).BddThreshold(0).Add());
+  }
+  LACE_ME;
+  return Dd(Mtbdd(mtbdd_apply(mtbdd.GetMTBDD(), rightDd.mtbdd.GetMTBDD(), TASK(geqOp)))); // BDD can be composed into MTBDD
 }
 
 bool Dd::evalAssignment(vector<int>& ddVarAssignment) const {
-  assert(ddPackage == CUDD_PACKAGE);
-  Number n = Dd(cuadd.Eval(&ddVarAssignment.front())).extractConst();
-  return n == Number(1);
+  if (ddPackage == CUDD_PACKAGE) {
+    Number n = Dd(cuadd.Eval(&ddVarAssignment.front())).extractConst();
+    return n == Number(1);
+  }
+  MTBDD d = mtbdd.GetMTBDD();
+  while (!mtbdd_isleaf(d)) {
+    int val = ddVarAssignment.at(mtbdd_getvar(d));
+    assert(val == 0 || val == 1);
+    d = val ? mtbdd_gethigh(d) : mtbdd_getlow(d);
+  }
+  return d == mtbdd_true;
 }
 
 Dd Dd::getAbstraction(Int ddVar, const vector<Int>& ddVarToCnfVarMap, const Map<Int, Number>& literalWeights, const Assignment& assignment, bool additiveFlag, vector<pair<Int, Dd>>& maximizationStack, const Cudd* mgr) const {
@@ -585,30 +917,84 @@ Dd Dd::getAbstraction(Int ddVar, const vector<Int>& ddVarToCnfVarMap, const Map<
 
   if (maximizerFormat && !additiveFlag) {
     Dd dsgn = highTerm.getBoolDiff(lowTerm); // derivative sign
-    maximizationStack.push_back({ddVar, dsgn});
+    {
+      const std::lock_guard<mutex> g(Executor::maximizationStackMutex); // only sibling subtrees run concurrently (maximizer rules out slicing), and they eliminate disjoint vars
+      maximizationStack.push_back({ddVar, dsgn});
+    }
     if (substitutionMaximization) {
-      return Dd(cuadd.Compose(dsgn.cuadd, ddVar));
+      if (ddPackage == CUDD_PACKAGE) {
+        return Dd(cuadd.Compose(dsgn.cuadd, ddVar));
+      }
+      sylvan::MtbddMap m;
+      m.put(ddVar, dsgn.mtbdd);
+      return Dd(mtbdd.Compose(m));
     }
   }
 
   return additiveFlag ? highTerm.getSum(lowTerm) : highTerm.getMax(lowTerm);
 }
 
+Dd Dd::getAndAbstraction(const Dd& dd, const vector<Int>& ddVars, const Cudd* mgr) const {
+  if (ddVars.empty()) {
+    return getProduct(dd);
+  }
+
+  vector<Int> sortedDdVars = ddVars;
+  sort(sortedDdVars.begin(), sortedDdVars.end(), greater<Int>()); // builds cube bottom-up
+
+  if (ddPackage == CUDD_PACKAGE) {
+    ADD cube = mgr->addOne();
+    for (Int ddVar : sortedDdVars) {
+      cube = mgr->addVar(ddVar) * cube;
+    }
+    DdManager* manager = mgr->getManager();
+    DdNode* result;
+    do {
+      manager->reordered = 0;
+      result = addWeightedAndAbstractRecur(manager, cuadd.getNode(), dd.cuadd.getNode(), cube.getNode());
+    } while (manager->reordered == 1);
+    return Dd(ADD(*mgr, result)); // checks for NULL result
+  }
+
+  vector<uint32_t> cubeVars(sortedDdVars.rbegin(), sortedDdVars.rend());
+  Mtbdd cube(mtbdd_set_from_array(&cubeVars.front(), cubeVars.size()));
+  LACE_ME;
+  return Dd(Mtbdd(CALL(weightedAndAbstractTask, mtbdd.GetMTBDD(), dd.mtbdd.GetMTBDD(), cube.GetMTBDD())));
+}
+
+Dd Dd::getCubeAbstraction(const vector<Int>& ddVars, const Cudd* mgr) const {
+  return getAndAbstraction(getOneDd(mgr), ddVars, mgr); // constant factor is free in weighted recursion
+}
+
 Dd Dd::getPrunedDd(Float lowerBound, const Cudd* mgr) const {
   assert(logCounting);
 
   TimePoint pruningStartPoint = util::getTimePoint();
 
-  ADD bound = mgr->constant(lowerBound);
-  ADD prunedDd = cuadd.LogThreshold(bound);
+  Dd prunedDd = *this;
+  if (ddPackage == CUDD_PACKAGE) {
+    ADD bound = mgr->constant(lowerBound);
+    prunedDd = Dd(cuadd.LogThreshold(bound));
+  }
+  else {
+    double bound = lowerBound;
+    size_t boundBits;
+    memcpy(&boundBits, &bound, sizeof(bound)); // uapply takes size_t param
+    LACE_ME;
+    prunedDd = Dd(Mtbdd(mtbdd_uapply(mtbdd.GetMTBDD(), TASK(logThresholdOp), boundBits)));
+  }
+
+  Tracer::addSpan("pruning", pruningStartPoint);
+
+  const std::lock_guard<mutex> g(statsMutex);
 
   pruningDuration += util::getDuration(pruningStartPoint);
 
-  if (prunedDd != cuadd) {
+  if (prunedDd != *this) {
     prunedDdCount++;
   }
 
-  return Dd(prunedDd);
+  return prunedDd;
 }
 
 void Dd::writeDotFile(const Cudd* mgr, const string& dotFileDir) const {
@@ -637,17 +1023,734 @@ void Dd::writeInfoFile(const Cudd* mgr, const string& filePath) {
   cout << "c wrote CUDD info to file " << filePath << "\n";
 }
 
+void Dd::writeSpillFile(const string& filePath) const {
+  assert(ddPackage == CUDD_PACKAGE);
+  Map<DdNode*, Int> nodeIds;
+  vector<DdNode*> nodes; // post-order
+  vector<pair<DdNode*, bool>> stack = {{cuadd.getNode(), false}}; // (node, whether children are done); ADDs have no complemented edges
+  while (!stack.empty()) {
+    auto [node, expandedFlag] = stack.back();
+    stack.pop_back();
+    if (nodeIds.contains(node)) {
+      continue;
+    }
+    if (cuddIsConstant(node) || expandedFlag) {
+      nodeIds[node] = nodes.size();
+      nodes.push_back(node);
+      continue;
+    }
+    stack.push_back({node, true});
+    stack.push_back({cuddE(node), false});
+    stack.push_back({cuddT(node), false});
+  }
+
+  std::ofstream spillFile(filePath, std::ios::binary);
+  if (!spillFile.is_open()) {
+    throw MyError("unable to write spill file '", filePath, "'");
+  }
+  Int nodeCount = nodes.size();
+  spillFile.write(reinterpret_cast<const char*>(&nodeCount), sizeof(Int));
+  for (DdNode* node : nodes) {
+    Int index = cuddIsConstant(node) ? -1 : node->index;
+    spillFile.write(reinterpret_cast<const char*>(&index), sizeof(Int));
+    if (index < 0) {
+      CUDD_VALUE_TYPE value = cuddV(node);
+      spillFile.write(reinterpret_cast<const char*>(&value), sizeof(CUDD_VALUE_TYPE));
+    }
+    else {
+      Int childIds[2] = {nodeIds.at(cuddT(node)), nodeIds.at(cuddE(node))};
+      spillFile.write(reinterpret_cast<const char*>(childIds), sizeof(childIds));
+    }
+  }
+  if (!spillFile) {
+    throw MyError("unable to write spill file '", filePath, "'");
+  }
+}
+
+Dd Dd::readSpillFile(const string& filePath, const Cudd* mgr) {
+  assert(ddPackage == CUDD_PACKAGE);
+  std::ifstream spillFile(filePath, std::ios::binary);
+  Int nodeCount = 0;
+  spillFile.read(reinterpret_cast<char*>(&nodeCount), sizeof(Int));
+  vector<Dd> dds; // node id |-> DD
+  for (Int id = 0; id < nodeCount && spillFile; id++) {
+    Int index;
+    spillFile.read(reinterpret_cast<char*>(&index), sizeof(Int));
+    if (index < 0) {
+      CUDD_VALUE_TYPE value;
+      spillFile.read(reinterpret_cast<char*>(&value), sizeof(CUDD_VALUE_TYPE));
+      dds.push_back(Dd(mgr->constant(value)));
+    }
+    else {
+      Int childIds[2];
+      spillFile.read(reinterpret_cast<char*>(childIds), sizeof(childIds));
+      dds.push_back(getNodeDd(index, dds.at(childIds[0]), dds.at(childIds[1]), mgr));
+    }
+  }
+  if (!spillFile || dds.empty()) {
+    throw MyError("unable to read spill file '", filePath, "'");
+  }
+  spillFile.close();
+  std::remove(filePath.c_str());
+  return dds.back();
+}
+
+/* class SubtreeCache ======================================================= */
+
+Map<Int, vector<Int>> SubtreeCache::frontierSliceVars;
+
+Set<Int> SubtreeCache::setFrontierSliceVars(const JoinNode* joinRoot, const Set<Int>& sliceVars) {
+  Map<Int, Set<Int>> subtreeSliceVarSets; // node index |-> slice vars in subtree, until parent is visited
+  joinRoot->visitPostOrder([&](const JoinNode* joinNode) {
+    Set<Int>& subtreeSliceVars = subtreeSliceVarSets[joinNode->nodeIndex];
+    if (joinNode->isTerminal()) {
+      for (Int var : joinNode->preProjectionVars) {
+        if (sliceVars.contains(var)) {
+          subtreeSliceVars.insert(var);
+        }
+      }
+      return;
+    }
+
+    for (const JoinNode* child : joinNode->children) {
+      util::unionize(subtreeSliceVars, subtreeSliceVarSets.at(child->nodeIndex));
+    }
+
+    for (const JoinNode* child : joinNode->children) {
+      const Set<Int>& childSliceVars = subtreeSliceVarSets.at(child->nodeIndex);
+      if (!child->isTerminal() && childSliceVars.size() < subtreeSliceVars.size()) {
+        frontierSliceVars[child->nodeIndex] = vector<Int>(childSliceVars.begin(), childSliceVars.end());
+      }
+      subtreeSliceVarSets.erase(child->nodeIndex);
+    }
+  });
+  return subtreeSliceVarSets.at(joinRoot->nodeIndex);
+}
+
+std::optional<Dd> SubtreeCache::findDd(Int nodeIndex, Int sliceBits) {
+  vector<pair<Int, Dd>>& dds = subtreeDds[nodeIndex];
+  for (auto it = dds.begin(); it != dds.end(); it++) {
+    if (it->first == sliceBits) {
+      std::rotate(it, std::next(it), dds.end());
+      hitCount++;
+      return dds.back().second;
+    }
+  }
+  return std::nullopt;
+}
+
+void SubtreeCache::insertDd(Int nodeIndex, Int sliceBits, const Dd& dd) {
+  vector<pair<Int, Dd>>& dds = subtreeDds[nodeIndex];
+  if (dds.size() >= SUBTREE_CACHE_WAYS) {
+    dds.erase(dds.begin()); // least recently used
+  }
+  dds.push_back({sliceBits, dd});
+}
+
+Int SubtreeCache::getSliceBits(const vector<Int>& vars, const Assignment& assignment) {
+  Int bits = 0;
+  for (size_t i = 0; i < vars.size(); i++) {
+    if (assignment.at(vars.at(i))) {
+      bits |= 1ll << i;
+    }
+  }
+  return bits;
+}
+
+/* class JoinPair =========================================================== */
+
+bool JoinPair::operator<(const JoinPair& joinPair) const {
+  if (sharingFlag != joinPair.sharingFlag) { // product of disjoint factors only grows
+    return !sharingFlag;
+  }
+  if (sizeEstimate != joinPair.sizeEstimate) {
+    return joinPriority == SMALLEST_PAIR ? sizeEstimate > joinPair.sizeEstimate : sizeEstimate < joinPair.sizeEstimate;
+  }
+  return pair<Int, Int>(i, j) > pair<Int, Int>(joinPair.i, joinPair.j);
+}
+
+/* class JoinScheduler ====================================================== */
+
+void JoinScheduler::projectPrivateVars(Int factorIndex) {
+  if (!projectingFlag) {
+    return;
+  }
+  Set<Int>& support = factorSupports.at(factorIndex);
+  vector<Int> privateDdVars;
+  for (Int ddVar : support) {
+    auto it = pendingVarFactorCounts.find(ddVar);
+    if (it != pendingVarFactorCounts.end() && it->second == 1) {
+      privateDdVars.push_back(ddVar);
+    }
+  }
+  if (!privateDdVars.empty()) {
+    factorDds.at(factorIndex) = factorDds.at(factorIndex).getCubeAbstraction(privateDdVars, mgr);
+    for (Int ddVar : privateDdVars) {
+      support.erase(ddVar);
+      pendingDdVars.erase(ddVar);
+      pendingVarFactorCounts.erase(ddVar);
+    }
+    factorVersions.at(factorIndex)++;
+  }
+}
+
+JoinPair JoinScheduler::getJoinPair(Int i, Int j) const {
+  const Set<Int>& smallerSupport = factorSupports.at(i).size() < factorSupports.at(j).size() ? factorSupports.at(i) : factorSupports.at(j);
+  const Set<Int>& largerSupport = &smallerSupport == &factorSupports.at(i) ? factorSupports.at(j) : factorSupports.at(i);
+  bool sharingFlag = false;
+  for (Int ddVar : smallerSupport) {
+    if (largerSupport.contains(ddVar)) {
+      sharingFlag = true;
+      break;
+    }
+  }
+  Float sizeEstimate = Float(factorDds.at(i).getNodeCount()) * factorDds.at(j).getNodeCount();
+  return JoinPair{sharingFlag, sizeEstimate, i, j, factorVersions.at(i), factorVersions.at(j)};
+}
+
+bool JoinScheduler::isCurrent(const JoinPair& joinPair) const {
+  return joinPair.iVersion == factorVersions.at(joinPair.i) && joinPair.jVersion == factorVersions.at(joinPair.j);
+}
+
+void JoinScheduler::joinFactors(Int factorCount) {
+  Int liveFactorCount = factorDds.size();
+  std::priority_queue<JoinPair> joinPairs; // stale pairs are skipped when popped
+  if (liveFactorCount > factorCount) {
+    for (Int i = 0; i < static_cast<Int>(factorDds.size()); i++) {
+      for (Int j = i + 1; j < static_cast<Int>(factorDds.size()); j++) {
+        joinPairs.push(getJoinPair(i, j));
+      }
+    }
+  }
+
+  while (liveFactorCount > factorCount) {
+    JoinPair joinPair = joinPairs.top();
+    joinPairs.pop();
+    if (!isCurrent(joinPair)) {
+      continue;
+    }
+
+    Int i = joinPair.i;
+    Int j = joinPair.j;
+    factorDds.at(i) = factorDds.at(i).getProduct(factorDds.at(j));
+    factorDds.at(j) = Dd::getOneDd(mgr); // releases joined factor
+    for (Int ddVar : factorSupports.at(j)) {
+      if (!factorSupports.at(i).insert(ddVar).second) {
+        auto it = pendingVarFactorCounts.find(ddVar);
+        if (it != pendingVarFactorCounts.end()) {
+          it->second--;
+        }
+      }
+    }
+    factorSupports.at(j).clear();
+    factorVersions.at(i)++;
+    factorVersions.at(j) = MIN_INT;
+    liveFactorCount--;
+    projectPrivateVars(i);
+
+    for (Int k = 0; k < static_cast<Int>(factorDds.size()); k++) {
+      if (k != i && factorVersions.at(k) != MIN_INT) {
+        joinPairs.push(getJoinPair(min(i, k), max(i, k)));
+      }
+    }
+  }
+
+  vector<Dd> liveFactorDds; // in original order
+  vector<Set<Int>> liveFactorSupports;
+  for (size_t k = 0; k < factorDds.size(); k++) {
+    if (factorVersions.at(k) != MIN_INT) {
+      liveFactorDds.push_back(std::move(factorDds.at(k)));
+      liveFactorSupports.push_back(std::move(factorSupports.at(k)));
+    }
+  }
+  factorDds = std::move(liveFactorDds);
+  factorSupports = std::move(liveFactorSupports);
+  factorVersions.assign(factorDds.size(), 0);
+}
+
+vector<Int> JoinScheduler::getPendingDdVars() const {
+  return vector<Int>(pendingDdVars.begin(), pendingDdVars.end());
+}
+
+JoinScheduler::JoinScheduler(vector<Dd>&& childDds, const vector<Int>& projectionDdVars, bool projectingFlag, const Cudd* mgr) {
+  this->factorDds = std::move(childDds);
+  this->pendingDdVars = Set<Int>(projectionDdVars.begin(), projectionDdVars.end());
+  this->projectingFlag = projectingFlag;
+  this->mgr = mgr;
+  assert(!factorDds.empty());
+
+  for (const Dd& dd : factorDds) {
+    factorSupports.push_back(dd.getSupport());
+    for (Int ddVar : factorSupports.back()) {
+      if (pendingDdVars.contains(ddVar)) {
+        pendingVarFactorCounts[ddVar]++;
+      }
+    }
+  }
+  factorVersions.assign(factorDds.size(), 0);
+  for (Int factorIndex = 0; factorIndex < static_cast<Int>(factorDds.size()); factorIndex++) {
+    projectPrivateVars(factorIndex);
+  }
+}
+
+/* class Profiler =========================================================== */
+
+std::list<vector<ProfileRecord>> Profiler::threadRecordLists;
+thread_local vector<ProfileRecord>* Profiler::threadRecords = nullptr;
+Map<const Assignment*, Int> Profiler::sliceIndices;
+Int Profiler::sliceCount = 0;
+mutex Profiler::profilerMutex;
+std::atomic<Int> Profiler::sylvanGcCount(0);
+
+bool Profiler::isEnabled() {
+  return !profileFilePath.empty();
+}
+
+void Profiler::beginSlice(const Assignment* assignment) {
+  if (isEnabled() || Tracer::isEnabled()) {
+    const std::lock_guard<mutex> g(profilerMutex);
+    sliceIndices[assignment] = sliceCount++; // slicing threads reuse assignment objects
+  }
+}
+
+Int Profiler::getSliceIndex(const Assignment* assignment) {
+  const std::lock_guard<mutex> g(profilerMutex);
+  auto it = sliceIndices.find(assignment);
+  return it == sliceIndices.end() ? -1 : it->second;
+}
+
+void Profiler::addRecord(const JoinNode* joinNode, const Assignment& assignment, TimePoint startPoint, size_t preAbstractionNodes, size_t preAbstractionLeaves, const Dd& dd, Int projectedVarCount, const Cudd* mgr) {
+  ProfileRecord record;
+  record.nodeIndex = joinNode->nodeIndex;
+  record.seconds = util::getDuration(startPoint);
+  record.preAbstractionNodes = preAbstractionNodes;
+  record.preAbstractionLeaves = preAbstractionLeaves;
+  record.postAbstractionNodes = dd.getNodeCount();
+  record.postAbstractionLeaves = dd.getLeafCount();
+  record.projectedVarCount = projectedVarCount;
+  record.memBytes = Dd::getMemInUse(mgr);
+  if (ddPackage == CUDD_PACKAGE) {
+    record.threadIndex = mgr->getManager()->threadIndex;
+    record.gcCount = mgr->ReadGarbageCollections();
+  }
+  else {
+    record.threadIndex = lace_get_worker()->worker;
+    record.gcCount = sylvanGcCount;
+  }
+
+  if (threadRecords == nullptr) {
+    const std::lock_guard<mutex> g(profilerMutex);
+    threadRecords = &threadRecordLists.emplace_back();
+  }
+  record.sliceIndex = getSliceIndex(&assignment);
+  threadRecords->push_back(record); // only this thread appends to its buffer
+}
+
+void Profiler::writeProfileFile() {
+  if (!isEnabled()) {
+    return;
+  }
+
+  vector<ProfileRecord> records;
+  for (const vector<ProfileRecord>& threadRecordList : threadRecordLists) {
+    records.insert(records.end(), threadRecordList.begin(), threadRecordList.end());
+  }
+  std::stable_sort(records.begin(), records.end(), [](const ProfileRecord& a, const ProfileRecord& b) {
+    return pair(a.sliceIndex, a.nodeIndex) < pair(b.sliceIndex, b.nodeIndex);
+  });
+
+  std::ofstream profileFile(profileFilePath);
+  if (!profileFile.is_open()) {
+    throw MyError("unable to write profile file '", profileFilePath, "'");
+  }
+  bool csvFlag = profileFilePath.size() >= 4 && profileFilePath.substr(profileFilePath.size() - 4) == ".csv";
+  if (csvFlag) {
+    profileFile << "joinNode,slice,thread,seconds,preAbstractionNodes,preAbstractionLeaves,postAbstractionNodes,postAbstractionLeaves,projectedVars,memBytes,gcCount\n";
+  }
+  for (const ProfileRecord& r : records) {
+    if (csvFlag) {
+      profileFile << r.nodeIndex + 1 << "," << r.sliceIndex << "," << r.threadIndex << "," << r.seconds << ",";
+      profileFile << r.preAbstractionNodes << "," << r.preAbstractionLeaves << "," << r.postAbstractionNodes << "," << r.postAbstractionLeaves << ",";
+      profileFile << r.projectedVarCount << "," << r.memBytes << "," << r.gcCount << "\n";
+    }
+    else {
+      profileFile << "{\"joinNode\": " << r.nodeIndex + 1 << ", \"slice\": " << r.sliceIndex << ", \"thread\": " << r.threadIndex << ", \"seconds\": " << r.seconds;
+      profileFile << ", \"preAbstractionNodes\": " << r.preAbstractionNodes << ", \"preAbstractionLeaves\": " << r.preAbstractionLeaves;
+      profileFile << ", \"postAbstractionNodes\": " << r.postAbstractionNodes << ", \"postAbstractionLeaves\": " << r.postAbstractionLeaves;
+      profileFile << ", \"projectedVars\": " << r.projectedVarCount << ", \"memBytes\": " << r.memBytes << ", \"gcCount\": " << r.gcCount << "}\n";
+    }
+  }
+  printRow("profileRecords", records.size());
+}
+
+/* class Tracer ============================================================= */
+
+std::list<vector<TraceEvent>> Tracer::threadEventLists;
+thread_local vector<TraceEvent>* Tracer::threadEvents = nullptr;
+thread_local Int Tracer::threadId = -1;
+Int Tracer::tracedThreadCount = 0;
+mutex Tracer::tracerMutex;
+
+bool Tracer::isEnabled() {
+  return !traceFilePath.empty();
+}
+
+void Tracer::addEvent(TraceEvent& event) {
+  if (threadEvents == nullptr) {
+    const std::lock_guard<mutex> g(tracerMutex);
+    threadEvents = &threadEventLists.emplace_back();
+    threadId = tracedThreadCount++;
+  }
+  event.threadId = threadId;
+  threadEvents->push_back(event); // only this thread appends to its buffer
+}
+
+void Tracer::addSpan(const string& name, TimePoint startPoint, Int sliceIndex, Int nodeIndex) {
+  if (!isEnabled()) {
+    return;
+  }
+  TraceEvent event;
+  event.name = name;
+  event.phase = 'X';
+  event.startMicroseconds = std::chrono::duration<Float, std::micro>(startPoint - toolStartPoint).count();
+  event.durationMicroseconds = std::chrono::duration<Float, std::micro>(util::getTimePoint() - startPoint).count();
+  event.sliceIndex = sliceIndex;
+  event.nodeIndex = nodeIndex;
+  addEvent(event);
+}
+
+void Tracer::addCounter(const string& name, Float value) {
+  if (!isEnabled()) {
+    return;
+  }
+  TraceEvent event;
+  event.name = name;
+  event.phase = 'C';
+  event.startMicroseconds = std::chrono::duration<Float, std::micro>(util::getTimePoint() - toolStartPoint).count();
+  event.value = value;
+  addEvent(event);
+}
+
+void Tracer::writeTraceFile() {
+  if (!isEnabled()) {
+    return;
+  }
+
+  std::ofstream traceFile(traceFilePath);
+  if (!traceFile.is_open()) {
+    throw MyError("unable to write trace file '", traceFilePath, "'");
+  }
+  traceFile << std::fixed << std::setprecision(3);
+  traceFile << "{\"traceEvents\": [\n";
+  bool firstFlag = true;
+  size_t eventCount = 0;
+  for (const vector<TraceEvent>& threadEventList : threadEventLists) {
+    for (const TraceEvent& e : threadEventList) {
+      traceFile << (firstFlag ? "" : ",\n");
+      firstFlag = false;
+      traceFile << "{\"name\": \"" << e.name << "\", \"ph\": \"" << e.phase << "\", \"pid\": 1, \"tid\": " << e.threadId << ", \"ts\": " << e.startMicroseconds;
+      if (e.phase == 'X') {
+        traceFile << ", \"dur\": " << e.durationMicroseconds << ", \"args\": {\"slice\": " << e.sliceIndex << ", \"joinNode\": " << (e.nodeIndex < 0 ? e.nodeIndex : e.nodeIndex + 1) << "}}";
+      }
+      else {
+        traceFile << ", \"args\": {\"" << e.name << "\": " << e.value << "}}";
+      }
+      eventCount++;
+    }
+  }
+  traceFile << "\n]}\n";
+  printRow("traceEvents", eventCount);
+}
+
+/* class Checkpointer ======================================================= */
+
+size_t Checkpointer::fingerprint = 0;
+vector<pair<Assignment, Number>> Checkpointer::finishedSlices;
+vector<Int> Checkpointer::slicingVars;
+Map<string, Int> Checkpointer::finishedSliceIndices;
+Set<string> Checkpointer::partlyFinishedSliceKeys;
+Number Checkpointer::totalSolution;
+TimePoint Checkpointer::writePoint;
+mutex Checkpointer::checkpointMutex;
+
+bool Checkpointer::isEnabled() {
+  return !checkpointFilePath.empty();
+}
+
+void Checkpointer::writeNumber(ostream& stream, const Number& n) {
+  if (multiplePrecision) {
+    stream << n.quotient.get_num() << "/" << n.quotient.get_den(); // Number(string) reads plain integer as mpf
+  }
+  else {
+    stream << std::hexfloat << n.fraction << std::defaultfloat; // stold reads hex and inf
+  }
+}
+
+void Checkpointer::writeJoinNode(ostream& stream, const JoinNode* joinRoot) {
+  vector<const JoinNode*> stack = {joinRoot};
+  while (!stack.empty()) {
+    const JoinNode* joinNode = stack.back();
+    stack.pop_back();
+
+    stream << "n " << joinNode->nodeIndex;
+    for (const JoinNode* child : joinNode->children) {
+      stream << " " << child->nodeIndex;
+    }
+    stream << " e";
+    for (Int var : joinNode->projectionVars) {
+      stream << " " << var;
+    }
+    stream << "\n";
+
+    stack.insert(stack.end(), joinNode->children.rbegin(), joinNode->children.rend()); // first child is written next
+  }
+}
+
+void Checkpointer::setFingerprint(const JoinNonterminal* joinRoot, const vector<Int>& sliceVars) {
+  std::ostringstream stream;
+  stream << "s " << weightedCountingMode << " " << projectedCounting << " " << existRandom << " " << logCounting << " " << multiplePrecision << " " << ddPackage << "\n";
+  stream << "v " << JoinNode::cnf.declaredVarCount;
+  for (Int var : sliceVars) {
+    stream << " " << var;
+  }
+  stream << "\n";
+  for (const Clause& clause : JoinNode::cnf.clauses) {
+    stream << (clause.xorFlag ? "x" : "c");
+    for (Int literal : std::set<Int>(clause.begin(), clause.end())) {
+      stream << " " << literal;
+    }
+    stream << "\n";
+  }
+  for (const auto& [literal, weight] : std::map<Int, Number>(JoinNode::cnf.literalWeights.begin(), JoinNode::cnf.literalWeights.end())) {
+    stream << "w " << literal << " ";
+    writeNumber(stream, weight);
+    stream << "\n";
+  }
+  writeJoinNode(stream, joinRoot);
+  fingerprint = std::hash<string>()(stream.str());
+}
+
+void Checkpointer::readCheckpointFile(const JoinNonterminal* joinRoot, const vector<Int>& sliceVars) {
+  totalSolution = logCounting ? Number(-INF) : Number();
+  writePoint = util::getTimePoint();
+  if (!isEnabled()) {
+    return;
+  }
+  slicingVars = sliceVars;
+  setFingerprint(joinRoot, sliceVars);
+
+  std::ifstream inputFileStream(checkpointFilePath);
+  if (!inputFileStream.is_open()) { // first run
+    return;
+  }
+
+  vector<pair<Assignment, Number>> slices;
+  Number total = totalSolution;
+  bool fingerprintFlag = false;
+  string line;
+  while (getline(inputFileStream, line)) {
+    vector<string> words = util::splitInputLine(line);
+    if (words.empty() || words.front() == "c") {
+      continue;
+    }
+    if (words.front() == "p") {
+      fingerprintFlag = words.size() == 3 && words.at(1) == "checkpoint" && words.at(2) == to_string(fingerprint);
+    }
+    else if (words.front() == "s" && words.size() == 2) {
+      total = Number(words.at(1));
+    }
+    else if (words.front() == "f" && words.size() >= 3 && words.back() == "0") {
+      Assignment assignment;
+      for (size_t i = 2; i < words.size() - 1; i++) {
+        Int literal = stoll(words.at(i));
+        assignment[abs(literal)] = literal > 0;
+      }
+      slices.push_back({assignment, Number(words.at(1))});
+    }
+    else {
+      throw MyError("unexpected line in checkpoint file '", checkpointFilePath, "': ", line);
+    }
+  }
+
+  if (!fingerprintFlag) {
+    cout << WARNING << "ignoring checkpoint file '" << checkpointFilePath << "' from different CNF, join tree or settings\n";
+    return;
+  }
+  for (const auto& [assignment, partialSolution] : slices) {
+    addFinishedSlice(assignment, partialSolution);
+  }
+  totalSolution = total;
+  printRow("checkpointSlices", finishedSlices.size());
+}
+
+string Checkpointer::getSliceKey(const Assignment& assignment) { // slices assign prefixes of slicingVars, so bits identify them
+  string key;
+  for (size_t i = 0; i < assignment.size(); i++) {
+    key += assignment.at(slicingVars.at(i)) ? '1' : '0';
+  }
+  return key;
+}
+
+void Checkpointer::addFinishedSlice(const Assignment& assignment, const Number& partialSolution) {
+  string key = getSliceKey(assignment);
+  finishedSliceIndices[key] = finishedSlices.size();
+  finishedSlices.push_back({assignment, partialSolution});
+  for (Int length = key.size() - 1; length > 0 && partlyFinishedSliceKeys.insert(key.substr(0, length)).second; length--) {} // shorter prefixes are present already
+}
+
+bool Checkpointer::isFinished(const Assignment& assignment, Number& partialSolution) {
+  if (!isEnabled()) {
+    return false;
+  }
+  const std::lock_guard<mutex> g(checkpointMutex);
+  auto it = finishedSliceIndices.find(getSliceKey(assignment));
+  if (it == finishedSliceIndices.end()) {
+    return false;
+  }
+  partialSolution = finishedSlices.at(it->second).second;
+  return true;
+}
+
+bool Checkpointer::isPartlyFinished(const Assignment& assignment) {
+  if (!isEnabled()) {
+    return false;
+  }
+  const std::lock_guard<mutex> g(checkpointMutex);
+  return partlyFinishedSliceKeys.contains(getSliceKey(assignment));
+}
+
+void Checkpointer::finishSlice(const Assignment& assignment, const Number& partialSolution) {
+  if (!isEnabled()) {
+    return;
+  }
+  const std::lock_guard<mutex> g(checkpointMutex);
+  addFinishedSlice(assignment, partialSolution);
+  if (existRandom) {
+    totalSolution = max(totalSolution, partialSolution);
+  }
+  else {
+    totalSolution = logCounting ? Number(totalSolution.getLogSumExp(partialSolution)) : totalSolution + partialSolution;
+  }
+  if (util::getDuration(writePoint) >= checkpointInterval) {
+    writeCheckpointFile();
+  }
+}
+
+void Checkpointer::writeCheckpointFile() { // caller holds checkpointMutex or is only thread
+  if (!isEnabled()) {
+    return;
+  }
+
+  string tempFilePath = checkpointFilePath + ".tmp";
+  {
+    std::ofstream checkpointFile(tempFilePath);
+    if (!checkpointFile.is_open()) {
+      throw MyError("unable to write checkpoint file '", tempFilePath, "'");
+    }
+    checkpointFile << "c dmc checkpoint: resumes with same CNF, join tree and counting settings\n";
+    checkpointFile << "p checkpoint " << fingerprint << "\n";
+    checkpointFile << "s ";
+    writeNumber(checkpointFile, totalSolution);
+    checkpointFile << "\n";
+    for (const auto& [assignment, partialSolution] : finishedSlices) {
+      checkpointFile << "f ";
+      writeNumber(checkpointFile, partialSolution);
+      for (const auto& [var, val] : std::map<Int, bool>(assignment.begin(), assignment.end())) {
+        checkpointFile << " " << (val ? var : -var);
+      }
+      checkpointFile << " 0\n";
+    }
+  }
+  if (std::rename(tempFilePath.c_str(), checkpointFilePath.c_str()) != 0) {
+    throw MyError("unable to rename '", tempFilePath, "' to '", checkpointFilePath, "'");
+  }
+  writePoint = util::getTimePoint();
+}
+
+/* class SubtreeFrame ======================================================= */
+
+SubtreeFrame::SubtreeFrame(const JoinNode* joinNode, const vector<const JoinNode*>& children, const Cudd* mgr) :
+  joinNode(joinNode), children(children), dd(Dd::getOneDd(mgr)), lastDd(Dd::getOneDd(mgr)) {}
+
+bool SubtreeFrame::isSpawned(Int position) const {
+  return position > firstNonterminalPosition && !children.at(position)->isTerminal();
+}
+
 /* class Executor =========================================================== */
 
 vector<pair<Int, Dd>> Executor::maximizationStack;
+mutex Executor::maximizationStackMutex;
+
+vector<const Cudd*> Executor::threadMgrs;
+
+Map<Int, vector<const JoinNode*>> Executor::childOrders;
 
+vector<Map<Int, Dd>> Executor::threadClauseDds;
+mutex Executor::clauseDdsMutex;
+
+std::atomic<Int> Executor::spillFileCount(0);
+
+mutex Executor::varStatsMutex;
 Map<Int, Float> Executor::varDurations;
 Map<Int, size_t> Executor::varDdSizes;
 
+const Cudd* Executor::getThreadMgr(Int threadIndex, Float mem) {
+  if (ddPackage == SYLVAN_PACKAGE) { // Sylvan has no manager object
+    return nullptr;
+  }
+
+  const Cudd*& mgr = threadMgrs.at(threadIndex);
+  if (mgr == nullptr) {
+    mgr = Dd::newMgr(mem, threadIndex);
+  }
+  else if (mem > 0) { // 0 means unlimited memory
+    mgr->SetMaxMemory(mem * MEGA);
+  }
+  return mgr;
+}
+
+void Executor::deleteThreadMgrs() {
+  threadClauseDds.clear(); // DDs must be released before their managers
+  for (const Cudd*& mgr : threadMgrs) {
+    delete mgr;
+    mgr = nullptr;
+  }
+}
+
+Int Executor::setChildOrders(const JoinNode* joinRoot) {
+  Map<Int, Int> needs; // node index |-> Sethi-Ullman number of subtree, until parent is visited
+  joinRoot->visitPostOrder([&](const JoinNode* joinNode) {
+    if (joinNode->isTerminal()) {
+      needs[joinNode->nodeIndex] = 1;
+      return;
+    }
+
+    vector<pair<Int, const JoinNode*>> neededChildren; // (Sethi-Ullman number, child)
+    for (const JoinNode* child : joinNode->children) {
+      neededChildren.push_back({needs.at(child->nodeIndex), child});
+      needs.erase(child->nodeIndex);
+    }
+    std::stable_sort(neededChildren.begin(), neededChildren.end(), [](const pair<Int, const JoinNode*>& a, const pair<Int, const JoinNode*>& b) {
+      return a.first > b.first; // most DDs alive first, while fewest sibling results are held
+    });
+
+    vector<const JoinNode*>& children = childOrders[joinNode->nodeIndex];
+    children.clear();
+    Int need = 0;
+    for (Int position = 0; position < static_cast<Int>(neededChildren.size()); position++) {
+      need = max(need, neededChildren.at(position).first + position);
+      children.push_back(neededChildren.at(position).second);
+    }
+    needs[joinNode->nodeIndex] = need;
+  });
+  return needs.at(joinRoot->nodeIndex);
+}
+
 void Executor::updateVarDurations(const JoinNode* joinNode, TimePoint startPoint) {
   if (verboseProfiling >= 1) {
     Float duration = util::getDuration(startPoint);
     if (duration > 0) {
+      const std::lock_guard<mutex> g(varStatsMutex);
       if (verboseProfiling >= 2) {
         printRow("solvingSeconds_joinNode" + to_string(joinNode->nodeIndex + 1), duration);
       }
@@ -662,120 +1765,324 @@ void Executor::updateVarDurations(const JoinNode* joinNode, TimePoint startPoint
       }
     }
   }
-}
+}
+
+void Executor::updateVarDdSizes(const JoinNode* joinNode, const Dd& dd) {
+  dd.updateMaxDdSizes(); // sampled once per join node instead of on every copy
+
+  if (verboseProfiling >= 1) {
+    size_t ddSize = dd.getNodeCount();
+
+    const std::lock_guard<mutex> g(varStatsMutex);
+    if (verboseProfiling >= 2) {
+      printRow("diagramNodes_joinNode" + to_string(joinNode->nodeIndex + 1), ddSize);
+    }
+
+    for (Int var : joinNode->preProjectionVars) {
+      if (varDdSizes.contains(var)) {
+        varDdSizes[var] = max(varDdSizes[var], ddSize);
+      }
+      else {
+        varDdSizes[var] = ddSize;
+      }
+    }
+  }
+}
+
+void Executor::printVarDurations() {
+  multimap<Float, Int, greater<Float>> timedVars = util::flipMap(varDurations); // duration |-> var
+  for (pair<Float, Int> timedVar : timedVars) {
+    printRow("totalSeconds_var" + to_string(timedVar.second), timedVar.first);
+  }
+}
+
+void Executor::printVarDdSizes() {
+  multimap<size_t, Int, greater<size_t>> sizedVars = util::flipMap(varDdSizes); // DD size |-> var
+  for (pair<size_t, Int> sizedVar : sizedVars) {
+    printRow("maxDiagramNodes_var" + to_string(sizedVar.second), sizedVar.first);
+  }
+}
+
+bool Executor::isUnderMemPressure(const Cudd* mgr) {
+  return spillRatio > 0 && ddPackage == CUDD_PACKAGE && maxMem > 0 && Dd::getMemInUse(mgr) > spillRatio * mgr->ReadMaxMemory();
+}
+
+string Executor::spillDd(Dd& dd, const Cudd* mgr) {
+  TimePoint spillStartPoint = util::getTimePoint();
+  string filePath = spillDirPath + "/dmc_" + to_string(getpid()) + "_" + to_string(spillFileCount++) + ".dd"; // unique across threads and concurrent runs
+  dd.writeSpillFile(filePath);
+  dd = Dd::getOneDd(mgr); // dead nodes are freed by next garbage collection
+  Dd::spilledDdCount++;
+  Tracer::addSpan("spill", spillStartPoint);
+  return filePath;
+}
+
+Dd Executor::reloadDd(const string& filePath, const Cudd* mgr) {
+  TimePoint reloadStartPoint = util::getTimePoint();
+  Dd dd = Dd::readSpillFile(filePath, mgr);
+  Tracer::addSpan("reload", reloadStartPoint);
+  return dd;
+}
+
+Dd Executor::getClauseDd(const Map<Int, Int>& cnfVarToDdVarMap, Int clauseIndex, const Cudd* mgr, const Assignment& assignment) {
+  Clause clause = JoinNode::cnf.clauses.at(clauseIndex);
+
+  vector<Int> assignedCnfVars;
+  for (Int literal : clause) {
+    Int cnfVar = abs(literal);
+    auto it = assignment.find(cnfVar);
+    if (it != assignment.end()) {
+      if (!clause.xorFlag && it->second == (literal > 0)) { // returns satisfied disjunctive clause
+        return Dd::getOneDd(mgr);
+      }
+      assignedCnfVars.push_back(cnfVar);
+    }
+  }
+
+  Map<Int, Dd>& clauseDds = threadClauseDds.at(mgr == nullptr ? 0 : mgr->getManager()->threadIndex);
+  std::unique_lock<mutex> lock(clauseDdsMutex, std::defer_lock); // Sylvan: Lace workers share one cache
+  if (ddPackage == SYLVAN_PACKAGE) {
+    lock.lock();
+  }
+  auto it = clauseDds.find(clauseIndex);
+  if (it == clauseDds.end()) {
+    if (lock.owns_lock()) { // Sylvan garbage collection waits for all workers
+      lock.unlock();
+    }
+    vector<pair<Int, bool>> ddLiterals;
+    for (Int literal : clause) {
+      ddLiterals.push_back({cnfVarToDdVarMap.at(abs(literal)), literal > 0});
+    }
+    Dd clauseDd = Dd::getClauseDd(ddLiterals, clause.xorFlag, mgr);
+    if (ddPackage == SYLVAN_PACKAGE) {
+      lock.lock();
+    }
+    it = clauseDds.emplace(clauseIndex, clauseDd).first;
+  }
+  Dd clauseDd = it->second;
+  if (lock.owns_lock()) {
+    lock.unlock();
+  }
+
+  if (assignedCnfVars.empty()) {
+    return clauseDd;
+  }
+  Map<Int, bool> ddVarAssignment;
+  for (Int cnfVar : assignedCnfVars) {
+    ddVarAssignment[cnfVarToDdVarMap.at(cnfVar)] = assignment.at(cnfVar);
+  }
+  return clauseDd.getCofactor(ddVarAssignment, mgr);
+}
+
+Dd Executor::solveTerminal(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const Cudd* mgr, const Assignment& assignment) {
+  TimePoint terminalStartPoint = util::getTimePoint();
+
+  Dd d = getClauseDd(cnfVarToDdVarMap, joinNode->nodeIndex, mgr, assignment);
+
+  if (Profiler::isEnabled()) {
+    Profiler::addRecord(joinNode, assignment, terminalStartPoint, d.getNodeCount(), d.getLeafCount(), d, 0, mgr);
+  }
+  if (Tracer::isEnabled()) {
+    Tracer::addSpan("clauseDiagram", terminalStartPoint, Profiler::getSliceIndex(&assignment), joinNode->nodeIndex);
+  }
+  updateVarDurations(joinNode, terminalStartPoint);
+  updateVarDdSizes(joinNode, d);
+
+  return d;
+}
+
+std::optional<Dd> Executor::enterSubtree(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment, SubtreeCache* subtreeCache, std::deque<SubtreeFrame>& frames) {
+  if (joinNode->isTerminal()) {
+    return solveTerminal(joinNode, cnfVarToDdVarMap, mgr, assignment);
+  }
+
+  SubtreeCache* cachingSubtreeCache = nullptr;
+  Int sliceBits = 0;
+  if (subtreeCache != nullptr) {
+    auto frontierIt = SubtreeCache::frontierSliceVars.find(joinNode->nodeIndex);
+    if (frontierIt != SubtreeCache::frontierSliceVars.end()) {
+      cachingSubtreeCache = subtreeCache;
+      sliceBits = SubtreeCache::getSliceBits(frontierIt->second, assignment);
+      std::optional<Dd> cachedDd = subtreeCache->findDd(joinNode->nodeIndex, sliceBits);
+      if (cachedDd) {
+        return cachedDd;
+      }
+    }
+  }
 
-void Executor::updateVarDdSizes(const JoinNode* joinNode, const Dd& dd) {
-  if (verboseProfiling >= 1) {
-    size_t ddSize = dd.getNodeCount();
+  SubtreeFrame& frame = frames.emplace_back(joinNode, childOrders.at(joinNode->nodeIndex), mgr);
+  frame.subtreeCache = cachingSubtreeCache;
+  frame.sliceBits = sliceBits;
 
-    if (verboseProfiling >= 2) {
-      printRow("diagramNodes_joinNode" + to_string(joinNode->nodeIndex + 1), ddSize);
+  vector<Int>& fusedDdVars = frame.fusedDdVars;
+  bool fusingFlag = !maximizerFormat && logBound == -INF; // maximizer and pruning need one var at a time
+  for (Int cnfVar : joinNode->projectionVars) {
+    if (!assignment.contains(cnfVar)) {
+      Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+      if (!fusedDdVars.empty() && Dd::ddVarAdditiveFlags.at(ddVar) != Dd::ddVarAdditiveFlags.at(fusedDdVars.front())) {
+        fusingFlag = false; // mixed sum and max
+      }
+      fusedDdVars.push_back(ddVar);
     }
+  }
+  frame.fusingFlag = fusingFlag && !fusedDdVars.empty();
 
-    for (Int var : joinNode->preProjectionVars) {
-      if (varDdSizes.contains(var)) {
-        varDdSizes[var] = max(varDdSizes[var], ddSize);
+  const vector<const JoinNode*>& children = frame.children;
+  if (ddPackage == SYLVAN_PACKAGE && threadCount > 1) { // sibling subtrees are independent
+    auto it = find_if(children.begin(), children.end(), [](const JoinNode* child) { return !child->isTerminal(); });
+    frame.firstNonterminalPosition = it - children.begin(); // solved in frame loop, so chain of nonterminals needs no native stack
+    LACE_ME;
+    for (Int position = children.size() - 1; position > frame.firstNonterminalPosition; position--) { // idle workers may steal spawned children
+      if (frame.isSpawned(position)) {
+        mtbdd_refs_spawn(SPAWN(solveSubtreeTask, children.at(position), &cnfVarToDdVarMap, &ddVarToCnfVarMap, &assignment));
+      }
+    }
+  }
+  if (frame.fusingFlag) { // abstracts vars as soon as child DDs arrive
+    vector<vector<Int>> childVarSets;
+    for (const JoinNode* child : children) {
+      childVarSets.push_back(child->getPostProjectionVars());
+    }
+    vector<Int> unmentionedDdVars;
+    for (Int ddVar : fusedDdVars) {
+      Int cnfVar = ddVarToCnfVarMap.at(ddVar);
+      Int lastPosition = -1;
+      Int mentionCount = 0;
+      for (Int position = 0; position < static_cast<Int>(children.size()); position++) {
+        if (util::isSortedMember(childVarSets.at(position), cnfVar)) {
+          lastPosition = position;
+          mentionCount++;
+        }
+      }
+      bool eagerFlag = joinPriority == ARBITRARY_PAIR ? lastPosition >= 0 && lastPosition < static_cast<Int>(children.size()) - 1 : mentionCount == 1; // pair priorities join children in any order, so only vars of one child are safe
+      if (eagerFlag) {
+        frame.lastMentions[lastPosition].push_back(ddVar);
       }
       else {
-        varDdSizes[var] = ddSize;
+        unmentionedDdVars.push_back(ddVar); // left for join scheduler or fused abstraction
       }
     }
+    fusedDdVars = unmentionedDdVars;
   }
-}
 
-void Executor::printVarDurations() {
-  multimap<Float, Int, greater<Float>> timedVars = util::flipMap(varDurations); // duration |-> var
-  for (pair<Float, Int> timedVar : timedVars) {
-    printRow("totalSeconds_var" + to_string(timedVar.second), timedVar.first);
-  }
+  return std::nullopt;
 }
 
-void Executor::printVarDdSizes() {
-  multimap<size_t, Int, greater<size_t>> sizedVars = util::flipMap(varDdSizes); // DD size |-> var
-  for (pair<size_t, Int> sizedVar : sizedVars) {
-    printRow("maxDiagramNodes_var" + to_string(sizedVar.second), sizedVar.first);
+void Executor::spillBeforeChild(SubtreeFrame& frame, const Cudd* mgr) {
+  if (joinPriority == ARBITRARY_PAIR) {
+    if (frame.position > 0 && isUnderMemPressure(mgr)) {
+      frame.spillFilePath = spillDd(frame.dd, mgr);
+      Dd::collectGarbage(mgr);
+    }
+  }
+  else if (!frame.childDdList.empty() && isUnderMemPressure(mgr)) { // pending siblings wait on disk while next subtree is solved
+    for (size_t position = 0; position < frame.childDdList.size(); position++) {
+      if (frame.spillFilePaths.at(position).empty()) {
+        frame.spillFilePaths.at(position) = spillDd(frame.childDdList.at(position), mgr);
+      }
+    }
+    Dd::collectGarbage(mgr);
   }
 }
 
-Dd Executor::getClauseDd(const Map<Int, Int>& cnfVarToDdVarMap, const Clause& clause, const Cudd* mgr, const Assignment& assignment) {
-  Dd clauseDd = Dd::getZeroDd(mgr);
-  for (Int literal : clause) {
-    bool val = literal > 0;
-    Int cnfVar = abs(literal);
-    auto it = assignment.find(cnfVar);
-    if (it != assignment.end()) { // literal has assigned value
-      if (it->second == val) {
-        if (clause.xorFlag) { // flips polarity
-          clauseDd = clauseDd.getXor(Dd::getOneDd(mgr));
-        }
-        else { // returns satisfied disjunctive clause
-          return Dd::getOneDd(mgr);
-        }
-      } // excludes unsatisfied literal from clause otherwise
+void Executor::addChildDd(SubtreeFrame& frame, Dd childDd, const Cudd* mgr, const Assignment& assignment) {
+  if (joinPriority == ARBITRARY_PAIR) {
+    TimePoint joinStartPoint = util::getTimePoint();
+    if (!frame.spillFilePath.empty()) {
+      frame.dd = reloadDd(frame.spillFilePath, mgr);
+      frame.spillFilePath.clear();
     }
-    else { // literal is unassigned
-      Int ddVar = cnfVarToDdVarMap.at(cnfVar);
-      Dd literalDd = Dd::getVarDd(ddVar, val, mgr);
-      clauseDd = clause.xorFlag ? clauseDd.getXor(literalDd) : clauseDd.getMax(literalDd);
+    if (frame.fusingFlag && frame.position == static_cast<Int>(frame.children.size()) - 1) {
+      frame.lastDd = std::move(childDd);
+    }
+    else {
+      frame.dd = frame.dd.getProduct(childDd); // childDd is released before next sibling is solved
+      auto it = frame.lastMentions.find(frame.position);
+      if (it != frame.lastMentions.end()) {
+        frame.dd = frame.dd.getCubeAbstraction(it->second, mgr);
+      }
+    }
+    frame.eagerJoinDuration += util::getTimePoint() - joinStartPoint;
+    if (Tracer::isEnabled()) {
+      Tracer::addSpan("join", joinStartPoint, Profiler::getSliceIndex(&assignment), frame.joinNode->nodeIndex);
     }
   }
-  return clauseDd;
+  else { // pair priorities need all child DDs to pick pairs, so only vars private to childDd are abstracted now
+    auto it = frame.lastMentions.find(frame.position);
+    if (it != frame.lastMentions.end()) {
+      TimePoint abstractionStartPoint = util::getTimePoint();
+      childDd = childDd.getCubeAbstraction(it->second, mgr);
+      frame.eagerJoinDuration += util::getTimePoint() - abstractionStartPoint;
+    }
+    frame.childDdList.push_back(std::move(childDd));
+    frame.spillFilePaths.push_back("");
+  }
+  frame.position++;
 }
 
-Dd Executor::solveSubtree(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment) {
-  if (joinNode->isTerminal()) {
-    TimePoint terminalStartPoint = util::getTimePoint();
-
-    Dd d = getClauseDd(cnfVarToDdVarMap, JoinNode::cnf.clauses.at(joinNode->nodeIndex), mgr, assignment);
-
-    updateVarDurations(joinNode, terminalStartPoint);
-    updateVarDdSizes(joinNode, d);
-
-    return d;
-  }
+Dd Executor::finishSubtree(SubtreeFrame& frame, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment) {
+  const JoinNode* joinNode = frame.joinNode;
+  vector<Dd>& childDdList = frame.childDdList;
+  vector<Int>& fusedDdVars = frame.fusedDdVars;
+  bool fusingFlag = frame.fusingFlag;
+  Dd& dd = frame.dd;
+  Dd& lastDd = frame.lastDd;
 
-  vector<Dd> childDdList;
-  for (JoinNode* child : joinNode->children) {
-    childDdList.push_back(solveSubtree(child, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment));
+  for (size_t position = 0; position < frame.spillFilePaths.size(); position++) {
+    if (!frame.spillFilePaths.at(position).empty()) {
+      childDdList.at(position) = reloadDd(frame.spillFilePaths.at(position), mgr);
+    }
   }
 
-  TimePoint nonterminalStartPoint = util::getTimePoint();
-  Dd dd = Dd::getOneDd(mgr);
+  TimePoint joinStartPoint = util::getTimePoint();
+  TimePoint nonterminalStartPoint = joinStartPoint - frame.eagerJoinDuration;
 
-  if (joinPriority == ARBITRARY_PAIR) { // arbitrarily multiplies child decision diagrams
-    for (Dd childDd : childDdList) {
-      dd = dd.getProduct(childDd);
+  if (childDdList.empty()) {} // already folded
+  else if (joinPriority == ARBITRARY_PAIR) { // arbitrarily multiplies child decision diagrams
+    for (size_t childIndex = 0; childIndex < childDdList.size(); childIndex++) {
+      if (fusingFlag && childIndex == childDdList.size() - 1) {
+        lastDd = std::move(childDdList.at(childIndex));
+      }
+      else {
+        dd = dd.getProduct(childDdList.at(childIndex));
+      }
     }
   }
-  else { // Dd::operator< handles both biggest-first and smallest-first
-    std::priority_queue<Dd> childDdQueue;
-    for (Dd childDd : childDdList) {
-      childDdQueue.push(childDd);
-    }
-    assert(!childDdQueue.empty());
-    while (childDdQueue.size() >= 2) {
-      Dd dd1 = childDdQueue.top();
-      childDdQueue.pop();
-      Dd dd2 = childDdQueue.top();
-      childDdQueue.pop();
-      Dd dd3 = dd1.getProduct(dd2);
-      childDdQueue.push(dd3);
+  else {
+    JoinScheduler joinScheduler(std::move(childDdList), fusedDdVars, fusingFlag, mgr);
+    joinScheduler.joinFactors(fusingFlag ? 2 : 1);
+    dd = std::move(joinScheduler.factorDds.front());
+    if (joinScheduler.factorDds.size() > 1) {
+      lastDd = std::move(joinScheduler.factorDds.back());
     }
-    dd = childDdQueue.top();
+    fusedDdVars = joinScheduler.getPendingDdVars(); // others were abstracted early
   }
 
-  for (Int cnfVar : joinNode->projectionVars) {
-    Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+  if (Tracer::isEnabled() && !childDdList.empty()) {
+    Tracer::addSpan("join", joinStartPoint, Profiler::getSliceIndex(&assignment), joinNode->nodeIndex);
+  }
+  TimePoint abstractionStartPoint = util::getTimePoint();
 
-    bool additiveFlag = JoinNode::cnf.outerVars.contains(cnfVar);
-    if (existRandom) {
-      additiveFlag = !additiveFlag;
-    }
+  size_t preAbstractionNodes = 0;
+  size_t preAbstractionLeaves = 0;
+  if (Profiler::isEnabled()) { // product of last two factors is never built when fusing
+    preAbstractionNodes = dd.getNodeCount() + (fusingFlag ? lastDd.getNodeCount() : 0);
+    preAbstractionLeaves = dd.getLeafCount() + (fusingFlag ? lastDd.getLeafCount() : 0);
+  }
 
-    dd = dd.getAbstraction(ddVar, ddVarToCnfVarMap, JoinNode::cnf.literalWeights, assignment, additiveFlag, maximizationStack, mgr);
+  if (fusingFlag) {
+    dd = dd.getAndAbstraction(lastDd, fusedDdVars, mgr);
+  }
 
+  auto pruneDd = [&dd, mgr](const vector<Int>& cnfVars) { // after abstracting cnfVars
     if (logBound > -INF) {
-      if (JoinNode::cnf.literalWeights.at(cnfVar) != Number(1) || JoinNode::cnf.literalWeights.at(-cnfVar) != Number(1)) {
+      bool weightedFlag = false;
+      for (Int cnfVar : cnfVars) {
+        if (JoinNode::cnf.literalWeights.at(cnfVar) != Number(1) || JoinNode::cnf.literalWeights.at(-cnfVar) != Number(1)) {
+          weightedFlag = true;
+        }
+      }
+      if (weightedFlag) {
         Dd prunedDd = dd.getPrunedDd(logBound, mgr);
         if (prunedDd != dd) {
           if (verboseSolving >= 3) {
@@ -789,33 +2096,157 @@ Dd Executor::solveSubtree(const JoinNode* joinNode, const Map<Int, Int>& cnfVarT
         }
       }
     }
+  };
+
+  vector<Int> groupCnfVars; // consecutive unassigned projection vars with same additive flag
+  vector<Int> groupDdVars;
+  auto abstractGroup = [&]() { // one cube abstraction per group instead of one pass per var
+    if (!groupDdVars.empty()) {
+      dd = dd.getCubeAbstraction(groupDdVars, mgr);
+      pruneDd(groupCnfVars);
+      groupCnfVars.clear();
+      groupDdVars.clear();
+    }
+  };
+
+  for (Int cnfVar : joinNode->projectionVars) {
+    bool assignedFlag = assignment.contains(cnfVar);
+    if (fusingFlag && !assignedFlag) { // already abstracted
+      continue;
+    }
+
+    Int ddVar = cnfVarToDdVarMap.at(cnfVar);
+    bool additiveFlag = Dd::ddVarAdditiveFlags.at(ddVar);
+
+    if (!assignedFlag && !(maximizerFormat && !additiveFlag)) { // maximizer needs one derivative sign per max var
+      if (!groupDdVars.empty() && Dd::ddVarAdditiveFlags.at(groupDdVars.front()) != additiveFlag) { // sum and max do not commute
+        abstractGroup();
+      }
+      groupCnfVars.push_back(cnfVar);
+      groupDdVars.push_back(ddVar);
+      continue;
+    }
+
+    abstractGroup();
+    dd = dd.getAbstraction(ddVar, ddVarToCnfVarMap, JoinNode::cnf.literalWeights, assignment, additiveFlag, maximizationStack, mgr);
+    pruneDd({cnfVar});
   }
+  abstractGroup();
 
+  if (Profiler::isEnabled()) {
+    Profiler::addRecord(joinNode, assignment, nonterminalStartPoint, preAbstractionNodes, preAbstractionLeaves, dd, joinNode->projectionVars.size(), mgr);
+  }
+  if (Tracer::isEnabled()) {
+    Tracer::addSpan("abstraction", abstractionStartPoint, Profiler::getSliceIndex(&assignment), joinNode->nodeIndex);
+    Tracer::addCounter("diagramNodes", dd.getNodeCount());
+    Tracer::addCounter("managerMemory", Dd::getMemInUse(mgr));
+  }
   updateVarDurations(joinNode, nonterminalStartPoint);
   updateVarDdSizes(joinNode, dd);
 
-  return dd;
+  if (frame.subtreeCache != nullptr) {
+    frame.subtreeCache->insertDd(joinNode->nodeIndex, frame.sliceBits, dd);
+  }
+
+  return std::move(dd);
 }
 
-void Executor::solveThreadSlices(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Float threadMem, Int threadIndex, const vector<vector<Assignment>>& threadAssignmentLists, Number& totalSolution, mutex& solutionMutex) {
-  const vector<Assignment>& threadAssignments = threadAssignmentLists.at(threadIndex);
-  for (Int threadAssignmentIndex = 0; threadAssignmentIndex < threadAssignments.size(); threadAssignmentIndex++) {
-    TimePoint sliceStartPoint = util::getTimePoint();
+Dd Executor::solveSubtree(const JoinNode* joinNode, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, const Cudd* mgr, const Assignment& assignment, SubtreeCache* subtreeCache) {
+  std::deque<SubtreeFrame> frames; // path from joinNode to current nonterminal
+  std::optional<Dd> subtreeDd = enterSubtree(joinNode, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment, subtreeCache, frames);
+  while (!frames.empty()) {
+    SubtreeFrame& frame = frames.back();
+    if (frame.position < static_cast<Int>(frame.children.size())) {
+      spillBeforeChild(frame, mgr);
+      if (frame.isSpawned(frame.position)) { // earlier spawned siblings are synced, so this is most recent task
+        LACE_ME;
+        subtreeDd = Dd(Mtbdd(mtbdd_refs_sync(SYNC(solveSubtreeTask))));
+      }
+      else {
+        subtreeDd = enterSubtree(frame.children.at(frame.position), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment, subtreeCache, frames);
+      }
+    }
+    else {
+      subtreeDd = finishSubtree(frame, cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment);
+      frames.pop_back();
+    }
+    if (subtreeDd && !frames.empty()) {
+      addChildDd(frames.back(), std::move(*subtreeDd), mgr, assignment);
+      subtreeDd.reset();
+    }
+  }
+  return std::move(*subtreeDd);
+}
 
-    Number partialSolution = solveSubtree(static_cast<const JoinNode*>(joinRoot), cnfVarToDdVarMap, ddVarToCnfVarMap, Dd::newMgr(threadMem, threadIndex), threadAssignments.at(threadAssignmentIndex)).extractConst();
+int Executor::hasPassedSliceDeadline(const void* sliceStartPoint) {
+  return util::getDuration(*static_cast<const TimePoint*>(sliceStartPoint)) > sliceDeadline;
+}
+
+void Executor::throwSliceDeadlineException(string message) {
+  throw SliceDeadlineException(message);
+}
+
+void Executor::solveThreadSlices(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Float threadMem, Int threadIndex, SliceQueue& sliceQueue, Number& totalSolution, mutex& solutionMutex) {
+  Int threadCount = sliceQueue.threadRanges.size();
+  Int threadSliceIndex = 0;
+  SubtreeCache subtreeCache; // releases DDs before thread manager is deleted
+  Assignment assignment;
+  while (sliceQueue.popSlice(threadIndex, assignment)) {
+    Number checkpointSolution;
+    if (Checkpointer::isFinished(assignment, checkpointSolution)) { // already in totalSolution
+      sliceQueue.finishSlice();
+      continue;
+    }
+    if (Checkpointer::isPartlyFinished(assignment)) { // replays split from interrupted run
+      sliceQueue.splitSlice(assignment);
+      continue;
+    }
+
+    TimePoint sliceStartPoint = util::getTimePoint();
+    Profiler::beginSlice(&assignment);
+    const Cudd* mgr = getThreadMgr(threadIndex, threadMem);
+    if (sliceDeadline > 0 && sliceQueue.isSplittable(assignment)) {
+      mgr->RegisterTerminationCallback(hasPassedSliceDeadline, &sliceStartPoint);
+      mgr->setTerminationHandler(throwSliceDeadlineException);
+    }
+
+    Number partialSolution;
+    try {
+      bool cachingFlag = subtreeCaching && assignment.size() == sliceQueue.sliceVars.size(); // split slices assign extra vars
+      partialSolution = solveSubtree(static_cast<const JoinNode*>(joinRoot), cnfVarToDdVarMap, ddVarToCnfVarMap, mgr, assignment, cachingFlag ? &subtreeCache : nullptr).extractConst();
+    }
+    catch (const SliceDeadlineException&) {
+      mgr->UnregisterTerminationCallback();
+      mgr->ClearErrorCode();
+      Dd::collectGarbage(mgr);
+      sliceQueue.splitSlice(assignment);
+      Tracer::addSpan("splitSlice", sliceStartPoint, Profiler::getSliceIndex(&assignment));
+      if (verboseSolving >= 1) {
+        const std::lock_guard<mutex> g(solutionMutex);
+        cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadCount;
+        cout << " | split slice after " << util::getDuration(sliceStartPoint) << "s: { ";
+        assignment.printAssignment();
+        cout << " }\n";
+      }
+      continue;
+    }
+    mgr->UnregisterTerminationCallback();
+    Dd::collectGarbage(mgr); // frees slice DDs before next slice
+    Tracer::addSpan("slice", sliceStartPoint, Profiler::getSliceIndex(&assignment));
+    threadSliceIndex++;
 
     const std::lock_guard<mutex> g(solutionMutex);
 
     if (verboseSolving >= 1) {
-      cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadAssignmentLists.size();
-      cout << " | assignment " << setw(4) << threadAssignmentIndex + 1 << "/" << threadAssignments.size();
+      cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadCount;
+      cout << " | slice " << setw(4) << threadSliceIndex;
 
       cout << ": { ";
-      threadAssignments.at(threadAssignmentIndex).printAssignment();
+      assignment.printAssignment();
       cout << " }\n";
 
-      cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadAssignmentLists.size();
-      cout << " | assignment " << setw(4) << threadAssignmentIndex + 1 << "/" << threadAssignments.size();
+      cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadCount;
+      cout << " | slice " << setw(4) << threadSliceIndex;
       cout << " | seconds " << std::fixed << setw(10) << util::getDuration(sliceStartPoint);
       cout << " | solution " << setw(15) << partialSolution << "\n";
     }
@@ -826,81 +2257,65 @@ void Executor::solveThreadSlices(const JoinNonterminal* joinRoot, const Map<Int,
     else {
       totalSolution = logCounting ? Number(totalSolution.getLogSumExp(partialSolution)) : totalSolution + partialSolution;
     }
-  }
-}
-
-vector<vector<Assignment>> Executor::getThreadAssignmentLists(const JoinNonterminal* joinRoot, Int sliceVarOrderHeuristic) {
-  size_t sliceVarCount = ceill(log2l(threadCount * threadSliceCount));
-  sliceVarCount = min(sliceVarCount, JoinNode::cnf.outerVars.size());
-
-  Int remainingSliceCount = exp2l(sliceVarCount);
-  Int remainingThreadCount = threadCount;
-  vector<Int> threadSliceCounts;
-  while (remainingThreadCount > 0) {
-    Int sliceCount = ceill(static_cast<Float>(remainingSliceCount) / remainingThreadCount);
-    threadSliceCounts.push_back(sliceCount);
-    remainingSliceCount -= sliceCount;
-    remainingThreadCount--;
-  }
-  assert(remainingSliceCount == 0);
-
-  if (verboseSolving >= 1) {
-    cout << "c thread slice counts: { ";
-    for (Int sliceCount : threadSliceCounts) {
-      cout << sliceCount << " ";
-    }
-    cout << "}\n";
-  }
+    Checkpointer::finishSlice(assignment, partialSolution);
 
-  vector<Assignment> assignments = joinRoot->getOuterAssignments(sliceVarOrderHeuristic, sliceVarCount);
-  vector<vector<Assignment>> threadAssignmentLists;
-  vector<Assignment> threadAssignmentList;
-  for (Int assignmentIndex = 0, threadListIndex = 0; assignmentIndex < assignments.size() && threadListIndex < threadSliceCounts.size(); assignmentIndex++) {
-    threadAssignmentList.push_back(assignments.at(assignmentIndex));
-    if (threadAssignmentList.size() == threadSliceCounts.at(threadListIndex)) {
-      threadAssignmentLists.push_back(threadAssignmentList);
-      threadAssignmentList.clear();
-      threadListIndex++;
-    }
+    sliceQueue.finishSlice();
   }
 
-  if (verboseSolving >= 2) {
-    for (Int threadIndex = 0; threadIndex < threadAssignmentLists.size(); threadIndex++) {
-      const vector<Assignment>& threadAssignments = threadAssignmentLists.at(threadIndex);
-      cout << "c assignments in thread " << right << setw(4) << threadIndex + 1 << ":";
-      for (const Assignment& assignment : threadAssignments) {
-        cout << " { ";
-        assignment.printAssignment();
-        cout << " }";
-      }
-      cout << "\n";
-    }
+  if (subtreeCaching && verboseSolving >= 1) {
+    const std::lock_guard<mutex> g(solutionMutex);
+    cout << "c thread " << right << setw(4) << threadIndex + 1 << "/" << threadCount;
+    cout << " | subtree cache hits " << subtreeCache.hitCount << "\n";
   }
-
-  return threadAssignmentLists;
 }
 
 Number Executor::solveCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>& cnfVarToDdVarMap, const vector<Int>& ddVarToCnfVarMap, Int sliceVarOrderHeuristic) {
-  if (ddPackage == SYLVAN_PACKAGE) {
+  if (ddPackage == SYLVAN_PACKAGE && threadSliceCount == 1) {
+    Assignment assignment;
+    Profiler::beginSlice(&assignment);
     return solveSubtree(
       static_cast<const JoinNode*>(joinRoot),
       cnfVarToDdVarMap,
-      ddVarToCnfVarMap
+      ddVarToCnfVarMap,
+      nullptr,
+      assignment
     ).extractConst();
   }
 
-  vector<vector<Assignment>> threadAssignmentLists = getThreadAssignmentLists(joinRoot, sliceVarOrderHeuristic);
-  printRow("sliceWidth", joinRoot->getWidth(threadAssignmentLists.front().front())); // any assignment would work
-  Number totalSolution = logCounting ? Number(-INF) : Number();
+  size_t sliceVarCount = ceill(log2l(threadCount * threadSliceCount));
+  sliceVarCount = min(sliceVarCount, JoinNode::cnf.outerVars.size());
+
+  if (ddPackage == SYLVAN_PACKAGE) { // slices are Lace tasks over shared tables
+    vector<Int> sliceVars = joinRoot->getSliceVars(sliceVarOrderHeuristic, sliceVarCount);
+    Int sliceCount = exp2l(sliceVars.size());
+    printRow("sliceCount", sliceCount);
+    printRow("sliceWidth", joinRoot->getWidth(Assignment(sliceVars, 0))); // any assignment would work
+    Checkpointer::readCheckpointFile(joinRoot, sliceVars);
+
+    LACE_ME;
+    Number solution = Dd(Mtbdd(CALL(solveSlicesTask, joinRoot, &cnfVarToDdVarMap, &ddVarToCnfVarMap, &sliceVars, 0, sliceCount))).extractConst();
+    Checkpointer::writeCheckpointFile();
+    return solution;
+  }
+  vector<Int> outerVars = joinRoot->getSliceVars(sliceVarOrderHeuristic, sliceDeadline > 0 ? JoinNode::cnf.outerVars.size() : sliceVarCount); // extra vars for splitting
+  SliceQueue sliceQueue(outerVars, sliceVarCount, threadCount);
+  if (subtreeCaching) {
+    SubtreeCache::setFrontierSliceVars(joinRoot, Set<Int>(sliceQueue.sliceVars.begin(), sliceQueue.sliceVars.end()));
+    printRow("cachedSubtrees", SubtreeCache::frontierSliceVars.size());
+  }
+
+  printRow("sliceWidth", joinRoot->getWidth(Assignment(sliceQueue.sliceVars, 0))); // any assignment would work
+  Checkpointer::readCheckpointFile(joinRoot, outerVars); // split vars must also match
+  Number totalSolution = Checkpointer::totalSolution; // of slices finished before interruption
   mutex solutionMutex;
 
-  Float threadMem = maxMem / threadAssignmentLists.size();
+  Float threadMem = maxMem / sliceQueue.threadRanges.size();
   printRow("threadMaxMemMegabytes", threadMem);
 
   vector<thread> threads;
 
   Int threadIndex = 0;
-  for (; threadIndex < threadAssignmentLists.size() - 1; threadIndex++) {
+  for (; threadIndex < static_cast<Int>(sliceQueue.threadRanges.size()) - 1; threadIndex++) {
     threads.push_back(thread(
       solveThreadSlices,
       std::cref(joinRoot),
@@ -908,7 +2323,7 @@ Number Executor::solveCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>&
       std::cref(ddVarToCnfVarMap),
       threadMem,
       threadIndex,
-      threadAssignmentLists,
+      std::ref(sliceQueue),
       std::ref(totalSolution),
       std::ref(solutionMutex)
     ));
@@ -919,13 +2334,14 @@ Number Executor::solveCnf(const JoinNonterminal* joinRoot, const Map<Int, Int>&
     ddVarToCnfVarMap,
     threadMem,
     threadIndex,
-    threadAssignmentLists,
+    sliceQueue,
     totalSolution,
     solutionMutex
   );
   for (thread& t : threads) {
     t.join();
   }
+  Checkpointer::writeCheckpointFile();
 
   return totalSolution;
 }
@@ -937,7 +2353,7 @@ void Executor::setLogBound(const JoinNonterminal* joinRoot, const Map<Int, Int>&
       joinRoot,
       cnfVarToDdVarMap,
       ddVarToCnfVarMap,
-      Dd::newMgr(maxMem),
+      getThreadMgr(0, maxMem),
       Assignment(thresholdModel)
     ).extractConst().fraction;
     printRow("logBound", logBound);
@@ -950,7 +2366,7 @@ void Executor::setLogBound(const JoinNonterminal* joinRoot, const Map<Int, Int>&
       joinRoot,
       cnfVarToDdVarMap,
       ddVarToCnfVarMap,
-      Dd::newMgr(maxMem),
+      getThreadMgr(0, maxMem),
       model
     ).extractConst().fraction;
     printRow("logBound", logBound);
@@ -1157,7 +2573,7 @@ Number Executor::verifyMaximizer(
     joinRoot,
     cnfVarToDdVarMap,
     ddVarToCnfVarMap,
-    Dd::newMgr(maxMem),
+    getThreadMgr(0, maxMem),
     maximizer
   );
   Number solution = dd.extractConst();
@@ -1170,6 +2586,7 @@ Executor::Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int
 
   TimePoint ddVarOrderStartPoint = util::getTimePoint();
   vector<Int> ddVarToCnfVarMap = joinRoot->getVarOrder(ddVarOrderHeuristic); // e.g. [42, 13], i.e. ddVarOrder
+  Tracer::addSpan("diagramVarOrder", ddVarOrderStartPoint);
   if (verboseSolving >= 1) {
     printRow("diagramVarSeconds", util::getDuration(ddVarOrderStartPoint));
   }
@@ -1180,6 +2597,15 @@ Executor::Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int
     cnfVarToDdVarMap[cnfVar] = ddVar;
   }
 
+  if (ddPackage == CUDD_PACKAGE) {
+    threadMgrs.resize(threadCount, nullptr);
+  }
+  threadClauseDds.resize(ddPackage == CUDD_PACKAGE ? threadCount : 1);
+
+  setChildOrders(joinRoot);
+
+  Dd::setDdVarWeights(ddVarToCnfVarMap);
+
   setLogBound(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap);
 
   Number solution = solveCnf(joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, sliceVarOrderHeuristic);
@@ -1192,6 +2618,10 @@ Executor::Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int
     printRow("pruningSeconds", Dd::pruningDuration);
   }
 
+  if (spillRatio > 0) {
+    printRow("spilledDiagrams", Dd::spilledDdCount);
+  }
+
   printRow("maxDiagramLeaves", Dd::maxDdLeafCount);
   printRow("maxDiagramNodes", Dd::maxDdNodeCount);
 
@@ -1219,6 +2649,328 @@ Executor::Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int
       }
     }
   }
+
+  Profiler::writeProfileFile();
+
+  maximizationStack.clear(); // DDs must be released before their managers
+  Dd::releaseDdVarWeightLeaves();
+  deleteThreadMgrs();
+}
+
+/* Lace tasks (Sylvan) ====================================================== */
+
+bool isTrueLeaf(MTBDD leaf) {
+  if (logCounting) {
+    return mtbdd_getdouble(leaf) != -INF;
+  }
+  if (multiplePrecision) {
+    return mpq_sgn(reinterpret_cast<mpq_ptr>(mtbdd_getvalue(leaf))) != 0;
+  }
+  return mtbdd_getdouble(leaf) != 0;
+}
+
+TASK_IMPL_2(MTBDD, xorOp, MTBDD*, pa, MTBDD*, pb) {
+  MTBDD a = *pa;
+  MTBDD b = *pb;
+  if (!mtbdd_isleaf(a) || !mtbdd_isleaf(b)) {
+    if (a == b) { // x XOR x = 0
+      return Dd::zeroLeaf->mtbdd.GetMTBDD();
+    }
+    if (a < b) { // commutative op: normalizes operand order for operation cache
+      *pa = b;
+      *pb = a;
+    }
+    return mtbdd_invalid; // recurses
+  }
+
+  bool aVal = isTrueLeaf(a);
+  bool bVal = isTrueLeaf(b);
+  if (aVal && bVal) {
+    return Dd::zeroLeaf->mtbdd.GetMTBDD();
+  }
+  return aVal ? a : b; // reuses operand leaf instead of making new one
+}
+
+TASK_IMPL_2(MTBDD, logProductOp, MTBDD*, pa, MTBDD*, pb) {
+  MTBDD a = *pa;
+  MTBDD b = *pb;
+  if (mtbdd_isleaf(a) && mtbdd_isleaf(b)) {
+    return mtbdd_double(mtbdd_getdouble(a) + mtbdd_getdouble(b));
+  }
+  if (mtbdd_isleaf(a) || mtbdd_isleaf(b)) {
+    MTBDD leaf = mtbdd_isleaf(a) ? a : b;
+    if (mtbdd_getdouble(leaf) == -INF) { // log10(0) annihilates
+      return leaf;
+    }
+    if (mtbdd_getdouble(leaf) == 0) { // log10(1) is identity
+      return leaf == a ? b : a;
+    }
+  }
+  if (a < b) { // commutative op: normalizes operand order for operation cache
+    *pa = b;
+    *pb = a;
+  }
+  return mtbdd_invalid;
+}
+
+TASK_IMPL_2(MTBDD, logSumExpOp, MTBDD*, pa, MTBDD*, pb) {
+  MTBDD a = *pa;
+  MTBDD b = *pb;
+  if (mtbdd_isleaf(a) && mtbdd_isleaf(b)) {
+    return mtbdd_double(Number(mtbdd_getdouble(a)).getLogSumExp(Number(mtbdd_getdouble(b))));
+  }
+  if (mtbdd_isleaf(a) && mtbdd_getdouble(a) == -INF) { // log10(0) is identity
+    return b;
+  }
+  if (mtbdd_isleaf(b) && mtbdd_getdouble(b) == -INF) {
+    return a;
+  }
+  if (a < b) {
+    *pa = b;
+    *pb = a;
+  }
+  return mtbdd_invalid;
+}
+
+TASK_IMPL_2(MTBDD, logThresholdOp, MTBDD, a, size_t, boundBits) {
+  if (!mtbdd_isleaf(a)) {
+    return mtbdd_invalid;
+  }
+  double bound;
+  memcpy(&bound, &boundBits, sizeof(bound));
+  return mtbdd_getdouble(a) < bound ? mtbdd_double(-INF) : a;
+}
+
+TASK_IMPL_2(MTBDD, geqOp, MTBDD*, pa, MTBDD*, pb) {
+  MTBDD a = *pa;
+  MTBDD b = *pb;
+  if (a == b) {
+    return mtbdd_true;
+  }
+  if (mtbdd_isleaf(a) && mtbdd_isleaf(b)) {
+    if (multiplePrecision) { // exact with GMP leaves
+      return mpq_cmp(reinterpret_cast<mpq_ptr>(mtbdd_getvalue(a)), reinterpret_cast<mpq_ptr>(mtbdd_getvalue(b))) >= 0 ? mtbdd_true : mtbdd_false;
+    }
+    return mtbdd_getdouble(a) >= mtbdd_getdouble(b) ? mtbdd_true : mtbdd_false;
+  }
+  return mtbdd_invalid;
+}
+
+uint64_t weightedAndAbstractOpid;
+
+TASK_IMPL_3(MTBDD, weightedAndAbstractTask, MTBDD, a, MTBDD, b, MTBDD, cube) { // raw MTBDDs: intermediate results are protected with mtbdd_refs_push
+  MTBDD zero = Dd::zeroLeaf->mtbdd.GetMTBDD();
+  if (a == zero || b == zero) {
+    return zero;
+  }
+  mtbdd_apply_op productOp = logCounting ? TASK(logProductOp) : (multiplePrecision ? TASK(gmp_op_times) : TASK(mtbdd_op_times));
+  if (cube == mtbdd_true) { // no var left to abstract
+    return mtbdd_apply(a, b, productOp);
+  }
+
+  sylvan_gc_test();
+
+  if (a > b) { // commutative in a and b: normalizes operand order for operation cache
+    std::swap(a, b);
+  }
+  MTBDD result;
+  if (sylvan::cache_get3(weightedAndAbstractOpid, a, b, cube, &result)) {
+    return result;
+  }
+
+  uint32_t aVar = mtbdd_isleaf(a) ? UINT32_MAX : mtbdd_getvar(a);
+  uint32_t bVar = mtbdd_isleaf(b) ? UINT32_MAX : mtbdd_getvar(b);
+  uint32_t cubeVar = mtbdd_getvar(cube);
+  uint32_t topVar = min(aVar, bVar);
+
+  if (cubeVar < topVar) { // product does not depend on cube var
+    MTBDD r = mtbdd_refs_push(CALL(weightedAndAbstractTask, a, b, mtbdd_gethigh(cube)));
+    result = mtbdd_apply(r, Dd::ddVarWeightLeaves.at(cubeVar).at(2).mtbdd.GetMTBDD(), productOp);
+    mtbdd_refs_pop(1);
+  }
+  else {
+    MTBDD aLow = aVar == topVar ? mtbdd_getlow(a) : a;
+    MTBDD aHigh = aVar == topVar ? mtbdd_gethigh(a) : a;
+    MTBDD bLow = bVar == topVar ? mtbdd_getlow(b) : b;
+    MTBDD bHigh = bVar == topVar ? mtbdd_gethigh(b) : b;
+    MTBDD nextCube = cubeVar == topVar ? mtbdd_gethigh(cube) : cube;
+
+    mtbdd_refs_spawn(SPAWN(weightedAndAbstractTask, aHigh, bHigh, nextCube));
+    MTBDD low = mtbdd_refs_push(CALL(weightedAndAbstractTask, aLow, bLow, nextCube));
+    MTBDD high = mtbdd_refs_push(mtbdd_refs_sync(SYNC(weightedAndAbstractTask)));
+
+    if (cubeVar == topVar) {
+      const std::array<Dd, 3>& leaves = Dd::ddVarWeightLeaves.at(topVar);
+      MTBDD highTerm = mtbdd_refs_push(mtbdd_apply(high, leaves.at(0).mtbdd.GetMTBDD(), productOp));
+      MTBDD lowTerm = mtbdd_refs_push(mtbdd_apply(low, leaves.at(1).mtbdd.GetMTBDD(), productOp));
+      mtbdd_apply_op sumOp = logCounting ? TASK(logSumExpOp) : (multiplePrecision ? TASK(gmp_op_plus) : TASK(mtbdd_op_plus));
+      mtbdd_apply_op maxOp = multiplePrecision ? TASK(gmp_op_max) : TASK(mtbdd_op_max);
+      result = mtbdd_apply(highTerm, lowTerm, Dd::ddVarAdditiveFlags.at(topVar) ? sumOp : maxOp);
+      mtbdd_refs_pop(4);
+    }
+    else {
+      result = mtbdd_makenode(topVar, low, high);
+      mtbdd_refs_pop(2);
+    }
+  }
+
+  sylvan::cache_put3(weightedAndAbstractOpid, a, b, cube, result);
+  return result;
+}
+
+VOID_TASK_IMPL_0(countGarbageCollection) {
+  Profiler::sylvanGcCount++;
+}
+
+TASK_IMPL_4(MTBDD, solveSubtreeTask, const JoinNode*, joinNode, const VarMap*, cnfVarToDdVarMap, const vector<Int>*, ddVarToCnfVarMap, const Assignment*, assignment) {
+  return Executor::solveSubtree(joinNode, *cnfVarToDdVarMap, *ddVarToCnfVarMap, nullptr, *assignment).mtbdd.GetMTBDD(); // mtbdd_refs_spawn protects result until sync
+}
+
+TASK_IMPL_6(MTBDD, solveSlicesTask, const JoinNode*, joinRoot, const VarMap*, cnfVarToDdVarMap, const vector<Int>*, ddVarToCnfVarMap, const vector<Int>*, sliceVars, Int, firstSlice, Int, sliceCount) {
+  if (sliceCount == 1) {
+    Assignment assignment(*sliceVars, firstSlice);
+    Number checkpointSolution;
+    if (Checkpointer::isFinished(assignment, checkpointSolution)) { // leaf value as extracted, so no log conversion
+      return (logCounting ? Dd(Mtbdd::doubleTerminal(checkpointSolution.fraction)) : Dd::getConstDd(checkpointSolution, nullptr)).mtbdd.GetMTBDD();
+    }
+    Profiler::beginSlice(&assignment); // stolen subtree tasks still see slice assignment
+    TimePoint sliceStartPoint = util::getTimePoint();
+    Dd dd = Executor::solveSubtree(joinRoot, *cnfVarToDdVarMap, *ddVarToCnfVarMap, nullptr, assignment);
+    Tracer::addSpan("slice", sliceStartPoint, Profiler::getSliceIndex(&assignment));
+    Checkpointer::finishSlice(assignment, dd.extractConst());
+    return dd.mtbdd.GetMTBDD();
+  }
+
+  Int lowSliceCount = sliceCount / 2; // splits range in halves so idle workers can steal either half
+  mtbdd_refs_spawn(SPAWN(solveSlicesTask, joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, sliceVars, firstSlice, lowSliceCount));
+  Dd highDd(Mtbdd(CALL(solveSlicesTask, joinRoot, cnfVarToDdVarMap, ddVarToCnfVarMap, sliceVars, firstSlice + lowSliceCount, sliceCount - lowSliceCount)));
+  Dd lowDd(Mtbdd(mtbdd_refs_sync(SYNC(solveSlicesTask))));
+  return (existRandom ? lowDd.getMax(highDd) : lowDd.getSum(highDd)).mtbdd.GetMTBDD(); // gmp_plus with multiple precision
+}
+
+/* CUDD recursive operations ================================================ */
+
+DdNode* addWeightedAndAbstractRecur(DdManager* manager, DdNode* f, DdNode* g, DdNode* cube) {
+  DD_AOP productOp = logCounting ? Cudd_addPlus : Cudd_addTimes;
+  DdNode* zero = logCounting ? DD_MINUS_INFINITY(manager) : DD_ZERO(manager);
+  if (f == zero || g == zero) {
+    return zero;
+  }
+  if (cuddIsConstant(cube)) { // no var left to abstract
+    return cuddAddApplyRecur(manager, productOp, f, g);
+  }
+
+  if (f > g) { // commutative in f and g: normalizes operand order for computed table
+    std::swap(f, g);
+  }
+  DdNode* result = cuddCacheLookup(manager, DD_ADD_WEIGHTED_AND_ABSTRACT_TAG, f, g, cube);
+  if (result != NULL) {
+    return result;
+  }
+
+  auto getWeightNode = [manager](const Number& weight) {
+    return cuddUniqueConst(manager, logCounting ? weight.getLog10() : weight.fraction);
+  };
+
+  int fLevel = cuddI(manager, f->index);
+  int gLevel = cuddI(manager, g->index);
+  int cubeLevel = cuddI(manager, cube->index);
+  int topLevel = min(fLevel, gLevel);
+
+  if (cubeLevel < topLevel) { // product does not depend on cube var
+    DdNode* r = addWeightedAndAbstractRecur(manager, f, g, cuddT(cube));
+    if (r == NULL) {
+      return NULL;
+    }
+    cuddRef(r);
+    DdNode* w = getWeightNode(Dd::getAbsentVarWeight(cube->index));
+    if (w == NULL) {
+      Cudd_RecursiveDeref(manager, r);
+      return NULL;
+    }
+    cuddRef(w);
+    result = cuddAddApplyRecur(manager, productOp, r, w);
+    if (result == NULL) {
+      Cudd_RecursiveDeref(manager, r);
+      Cudd_RecursiveDeref(manager, w);
+      return NULL;
+    }
+    cuddRef(result);
+    Cudd_RecursiveDeref(manager, r);
+    Cudd_RecursiveDeref(manager, w);
+    cuddDeref(result);
+  }
+  else {
+    unsigned int index = fLevel == topLevel ? f->index : g->index;
+    DdNode* fT = fLevel == topLevel ? cuddT(f) : f;
+    DdNode* fE = fLevel == topLevel ? cuddE(f) : f;
+    DdNode* gT = gLevel == topLevel ? cuddT(g) : g;
+    DdNode* gE = gLevel == topLevel ? cuddE(g) : g;
+    DdNode* nextCube = cubeLevel == topLevel ? cuddT(cube) : cube;
+
+    DdNode* t = addWeightedAndAbstractRecur(manager, fT, gT, nextCube);
+    if (t == NULL) {
+      return NULL;
+    }
+    cuddRef(t);
+    DdNode* e = addWeightedAndAbstractRecur(manager, fE, gE, nextCube);
+    if (e == NULL) {
+      Cudd_RecursiveDeref(manager, t);
+      return NULL;
+    }
+    cuddRef(e);
+
+    if (cubeLevel == topLevel) { // abstracts var
+      vector<DdNode*> refs = {t, e}; // dereferenced before returning
+      auto derefAll = [manager, &refs]() {
+        for (DdNode* node : refs) {
+          Cudd_RecursiveDeref(manager, node);
+        }
+      };
+      const pair<Number, Number>& weights = Dd::ddVarWeights.at(index);
+      DdNode* highTerm = NULL;
+      DdNode* lowTerm = NULL;
+      for (bool val : {true, false}) {
+        DdNode* w = getWeightNode(val ? weights.first : weights.second);
+        if (w == NULL) {
+          derefAll();
+          return NULL;
+        }
+        cuddRef(w);
+        refs.push_back(w);
+        DdNode* term = cuddAddApplyRecur(manager, productOp, val ? t : e, w);
+        if (term == NULL) {
+          derefAll();
+          return NULL;
+        }
+        cuddRef(term);
+        refs.push_back(term);
+        (val ? highTerm : lowTerm) = term;
+      }
+      DD_AOP sumOp = logCounting ? Cudd_addLogSumExp : Cudd_addPlus;
+      result = cuddAddApplyRecur(manager, Dd::ddVarAdditiveFlags.at(index) ? sumOp : Cudd_addMaximum, highTerm, lowTerm);
+      if (result == NULL) {
+        derefAll();
+        return NULL;
+      }
+      cuddRef(result);
+      derefAll();
+      cuddDeref(result);
+    }
+    else {
+      result = t == e ? t : cuddUniqueInter(manager, index, t, e);
+      if (result == NULL) {
+        Cudd_RecursiveDeref(manager, t);
+        Cudd_RecursiveDeref(manager, e);
+        return NULL;
+      }
+      cuddDeref(t);
+      cuddDeref(e);
+    }
+  }
+
+  cuddCacheInsert(manager, DD_ADD_WEIGHTED_AND_ABSTRACT_TAG, f, g, cube, result);
+  return result;
 }
 
 /* class OptionRequirement ================================================== */
@@ -1317,7 +3069,7 @@ string OptionDict::helpMaximizerFormat() {
   string s = "maximizer format";
   s += requireOptions({
     OptionRequirement(EXIST_RANDOM_OPTION, "1"),
-    OptionRequirement(DD_PACKAGE_OPTION, CUDD_PACKAGE)
+    OptionRequirement(THREAD_SLICE_COUNT_OPTION, "1")
   });
   s += ": ";
   for (auto it = MAXIMIZER_FORMATS.begin(); it != MAXIMIZER_FORMATS.end(); it++) {
@@ -1357,7 +3109,7 @@ string OptionDict::helpJoinPriority() {
       s += ", ";
     }
   }
-  return s + "; string";
+  return s + " (" + ARBITRARY_PAIR + " multiplies each child DD into product as it arrives; others keep child DDs until all siblings are solved); string";
 }
 
 void OptionDict::runCommand() const {
@@ -1368,9 +3120,7 @@ void OptionDict::runCommand() const {
     printRow("projectedCounting", projectedCounting);
     printRow("existRandom", existRandom);
     printRow("diagramPackage", DD_PACKAGES.at(ddPackage));
-    if (ddPackage == CUDD_PACKAGE) {
-      printRow("logCounting", logCounting);
-    }
+    printRow("logCounting", logCounting);
     if (!projectedCounting && existRandom && logCounting) {
       if (logBound > -INF) {
         printRow("logBound", logBound);
@@ -1382,7 +3132,7 @@ void OptionDict::runCommand() const {
         printRow("satSolverPruning", satSolverPruning);
       }
     }
-    if (existRandom && ddPackage == CUDD_PACKAGE) {
+    if (existRandom) {
       printRow("maximizerFormat", MAXIMIZER_FORMATS.at(maximizerFormat));
     }
     if (maximizerFormat) {
@@ -1393,13 +3143,15 @@ void OptionDict::runCommand() const {
     }
     printRow("plannerWaitSeconds", plannerWaitDuration);
     printRow("threadCount", threadCount);
+    printRow("threadSliceCount", threadSliceCount);
     if (ddPackage == CUDD_PACKAGE) {
-      printRow("threadSliceCount", threadSliceCount);
+      printRow("subtreeCaching", subtreeCaching);
+      printRow("sliceDeadlineSeconds", sliceDeadline);
     }
     printRow("randomSeed", randomSeed);
     printRow("diagramVarOrderHeuristic", (ddVarOrderHeuristic < 0 ? "INVERSE_" : "") + CNF_VAR_ORDER_HEURISTICS.at(abs(ddVarOrderHeuristic)));
+    printRow("sliceVarOrderHeuristic", (sliceVarOrderHeuristic < 0 ? "INVERSE_" : "") + util::getVarOrderHeuristics().at(abs(sliceVarOrderHeuristic)));
     if (ddPackage == CUDD_PACKAGE) {
-      printRow("sliceVarOrderHeuristic", (sliceVarOrderHeuristic < 0 ? "INVERSE_" : "") + util::getVarOrderHeuristics().at(abs(sliceVarOrderHeuristic)));
       printRow("memSensitivityMegabytes", memSensitivity);
     }
     printRow("maxMemMegabytes", maxMem);
@@ -1409,19 +3161,38 @@ void OptionDict::runCommand() const {
       printRow("multiplePrecision", multiplePrecision);
     }
     printRow("joinPriority", JOIN_PRIORITIES.at(joinPriority));
+    if (!profileFilePath.empty()) {
+      printRow("profileFile", profileFilePath);
+    }
+    if (!traceFilePath.empty()) {
+      printRow("traceFile", traceFilePath);
+    }
+    if (spillRatio > 0) {
+      printRow("spillRatio", spillRatio);
+      printRow("spillDir", spillDirPath);
+    }
+    if (!checkpointFilePath.empty()) {
+      printRow("checkpointFile", checkpointFilePath);
+      printRow("checkpointIntervalSeconds", checkpointInterval);
+    }
     cout << "\n";
   }
 
   try {
+    TimePoint cnfStartPoint = util::getTimePoint();
     JoinNode::cnf.readCnfFile(cnfFilePath);
+    Tracer::addSpan("cnfParsing", cnfStartPoint);
 
     if (JoinNode::cnf.clauses.empty()) {
       cout << WARNING << "empty CNF\n";
       Executor::printAdjustedSolutionRows(logCounting ? Number() : Number("1"));
+      Tracer::writeTraceFile();
       return;
     }
 
+    TimePoint joinTreeStartPoint = util::getTimePoint();
     JoinTreeProcessor joinTreeProcessor(plannerWaitDuration);
+    Tracer::addSpan("plannerWait", joinTreeStartPoint);
 
     Map<Int, Number> unprunableWeights = JoinNode::cnf.getUnprunableWeights();
     if (!unprunableWeights.empty() && (logBound > -INF || !thresholdModel.empty() || satSolverPruning)) {
@@ -1443,6 +3214,8 @@ void OptionDict::runCommand() const {
       if (multiplePrecision) {
         sylvan::gmp_init();
       }
+      weightedAndAbstractOpid = sylvan::cache_next_opid();
+      sylvan::sylvan_gc_hook_pregc(TASK(countGarbageCollection));
     }
 
     Executor executor(joinTreeProcessor.getJoinTreeRoot(), ddVarOrderHeuristic, sliceVarOrderHeuristic);
@@ -1455,6 +3228,8 @@ void OptionDict::runCommand() const {
   catch (UnsatException) {
     Executor::printAdjustedSolutionRows(logCounting ? Number(-INF) : Number(), true);
   }
+
+  Tracer::writeTraceFile();
 }
 
 OptionDict::OptionDict(int argc, char** argv) {
@@ -1463,12 +3238,12 @@ OptionDict::OptionDict(int argc, char** argv) {
 
   using cxxopts::value;
   options.add_options()
-    (CNF_FILE_OPTION, "CNF file path; string (required)", value<string>())
+    (CNF_FILE_OPTION, "CNF file path, may be pipe or gzip/xz/zstd compressed; string (required)", value<string>())
     (WEIGHTED_COUNTING_OPTION, helpWeightedCounting(), value<Int>()->default_value("1"))
     (PROJECTED_COUNTING_OPTION, "projected counting (graded join tree): 0, 1; int", value<Int>()->default_value("0"))
     (EXIST_RANDOM_OPTION, "exist-random SAT (max-sum instead of sum-max): 0, 1; int", value<Int>()->default_value("0"))
     (DD_PACKAGE_OPTION, helpDdPackage(), value<string>()->default_value(CUDD_PACKAGE))
-    (LOG_COUNTING_OPTION, "logarithmic counting" + requireDdPackage(CUDD_PACKAGE) + ": 0, 1; int", value<Int>()->default_value("0"))
+    (LOG_COUNTING_OPTION, "logarithmic counting" + requireOption(MULTIPLE_PRECISION_OPTION, "0") + ": 0, 1; int", value<Int>()->default_value("0"))
     (LOG_BOUND_OPTION, helpLogBound(), value<string>()->default_value(to_string(-INF))) // cxxopts fails to parse "-inf" as Float
     (THRESHOLD_MODEL_OPTION, helpThresholdModel(), value<string>()->default_value(""))
     (SAT_SOLVER_PRUNING, helpSatSolverPruning(), value<Int>()->default_value("0"))
@@ -1477,7 +3252,9 @@ OptionDict::OptionDict(int argc, char** argv) {
     (SUBSTITUTION_MAXIMIZATION_OPTION, helpSubstitutionMaximization(), value<Int>()->default_value("0"))
     (PLANNER_WAIT_OPTION, "planner wait duration minimum (in seconds); float", value<Float>()->default_value("0.0"))
     (THREAD_COUNT_OPTION, "thread count [or 0 for hardware_concurrency value]; int", value<Int>()->default_value("1"))
-    (THREAD_SLICE_COUNT_OPTION, "thread slice count" + requireDdPackage(CUDD_PACKAGE) + "; int", value<Int>()->default_value("1"))
+    (THREAD_SLICE_COUNT_OPTION, "thread slice count; int", value<Int>()->default_value("1"))
+    (SUBTREE_CACHING_OPTION, "subtree caching across slices" + requireOptions({OptionRequirement(THREAD_SLICE_COUNT_OPTION, "1", ">"), OptionRequirement(MAXIMIZER_FORMAT_OPTION, to_string(NEITHER_FORMAT))}) + ": 0, 1; int", value<Int>()->default_value("0"))
+    (SLICE_DEADLINE_OPTION, "slice deadline (in seconds) for splitting running slice [or 0 for no splitting]" + requireDdPackage(CUDD_PACKAGE) + "; float", value<Float>()->default_value("0.0"))
     (RANDOM_SEED_OPTION, "random seed; int", value<Int>()->default_value("0"))
     (DD_VAR_OPTION, helpDiagramVarOrderHeuristic(), value<Int>()->default_value(to_string(MCS_HEURISTIC)))
     (SLICE_VAR_OPTION, helpSliceVarOrderHeuristic(), value<Int>()->default_value(to_string(BIGGEST_NODE_HEURISTIC)))
@@ -1490,6 +3267,12 @@ OptionDict::OptionDict(int argc, char** argv) {
     (VERBOSE_CNF_OPTION, util::helpVerboseCnfProcessing(), value<Int>()->default_value("0"))
     (VERBOSE_JOIN_TREE_OPTION, "verbose join-tree processing: 0, 1, 2", value<Int>()->default_value("0"))
     (VERBOSE_PROFILING_OPTION, "verbose profiling: 0, 1, 2; int", value<Int>()->default_value("0"))
+    (PROFILE_FILE_OPTION, "profile file with one record per join node per slice (CSV if path ends with .csv, JSON lines otherwise) [or empty for no file]; string", value<string>()->default_value(""))
+    (TRACE_FILE_OPTION, "trace file in Chrome trace-event format [or empty for no file]; string", value<string>()->default_value(""))
+    (CHECKPOINT_FILE_OPTION, "checkpoint file of finished slices, read at start and rewritten periodically [or empty for no file]; string", value<string>()->default_value(""))
+    (CHECKPOINT_INTERVAL_OPTION, "checkpoint interval (in seconds) [needs cp_arg]; float", value<Float>()->default_value("60"))
+    (SPILL_RATIO_OPTION, "spill ratio of manager memory above which pending diagrams are written to disk" + requireDdPackage(CUDD_PACKAGE) + " [or 0 for no spilling]; float", value<Float>()->default_value("0"))
+    (SPILL_DIR_OPTION, "spill directory for pending diagrams [needs sr_arg > 0]; string", value<string>()->default_value("/tmp"))
     (VERBOSE_SOLVING_OPTION, util::helpVerboseSolving(), value<Int>()->default_value("0"))
     (HELP_OPTION, "help")
   ;
@@ -1511,7 +3294,6 @@ OptionDict::OptionDict(int argc, char** argv) {
     assert(DD_PACKAGES.contains(ddPackage));
 
     logCounting = result[LOG_COUNTING_OPTION].as<Int>(); // global var
-    assert(!logCounting || ddPackage == CUDD_PACKAGE);
 
     logBound = stold(result[LOG_BOUND_OPTION].as<string>()); // global var
     assert(logBound == -INF || !projectedCounting);
@@ -1534,7 +3316,6 @@ OptionDict::OptionDict(int argc, char** argv) {
     maximizerFormat = result[MAXIMIZER_FORMAT_OPTION].as<Int>(); // global var
     assert(MAXIMIZER_FORMATS.contains(maximizerFormat));
     assert(!maximizerFormat || existRandom);
-    assert(!maximizerFormat || ddPackage == CUDD_PACKAGE);
 
     maximizerVerification = result[MAXIMIZER_VERIFICATION_OPTION].as<Int>(); // global var
     assert(!maximizerVerification || maximizerFormat);
@@ -1554,7 +3335,16 @@ OptionDict::OptionDict(int argc, char** argv) {
 
     threadSliceCount = result[THREAD_SLICE_COUNT_OPTION].as<Int>(); // global var
     threadSliceCount = max(threadSliceCount, 1ll);
-    assert(threadSliceCount == 1 || ddPackage == CUDD_PACKAGE);
+    assert(threadSliceCount == 1 || !maximizerFormat); // concurrent slices would push derivative signs of same vars onto maximization stack
+
+    subtreeCaching = result[SUBTREE_CACHING_OPTION].as<Int>(); // global var
+    assert(!subtreeCaching || ddPackage == CUDD_PACKAGE);
+    assert(!subtreeCaching || !maximizerFormat); // cached subtrees would skip maximization stack
+
+    sliceDeadline = result[SLICE_DEADLINE_OPTION].as<Float>(); // global var
+    sliceDeadline = max(sliceDeadline, 0.0l);
+    assert(sliceDeadline == 0 || ddPackage == CUDD_PACKAGE);
+    assert(sliceDeadline == 0 || !maximizerFormat); // split slices would leave derivative signs on maximization stack
 
     randomSeed = result[RANDOM_SEED_OPTION].as<Int>(); // global var
 
@@ -1579,6 +3369,7 @@ OptionDict::OptionDict(int argc, char** argv) {
 
     multiplePrecision = result[MULTIPLE_PRECISION_OPTION].as<Int>(); // global var
     assert(!multiplePrecision || ddPackage == SYLVAN_PACKAGE);
+    assert(!multiplePrecision || !logCounting);
 
     joinPriority = result[JOIN_PRIORITY_OPTION].as<string>(); //global var
     assert(JOIN_PRIORITIES.contains(joinPriority));
@@ -1588,7 +3379,25 @@ OptionDict::OptionDict(int argc, char** argv) {
     verboseJoinTree = result[VERBOSE_JOIN_TREE_OPTION].as<Int>(); // global var
 
     verboseProfiling = result[VERBOSE_PROFILING_OPTION].as<Int>(); // global var
-    assert(verboseProfiling <= 0 || threadCount == 1);
+
+    profileFilePath = result[PROFILE_FILE_OPTION].as<string>(); // global var
+
+    traceFilePath = result[TRACE_FILE_OPTION].as<string>(); // global var
+
+    checkpointFilePath = result[CHECKPOINT_FILE_OPTION].as<string>(); // global var
+    assert(checkpointFilePath.empty() || !maximizerFormat); // finished slices would leave no derivative signs on maximization stack
+
+    assert(!result.count(CHECKPOINT_INTERVAL_OPTION) || !checkpointFilePath.empty());
+    checkpointInterval = result[CHECKPOINT_INTERVAL_OPTION].as<Float>(); // global var
+    checkpointInterval = max(checkpointInterval, 0.0l);
+
+    spillRatio = result[SPILL_RATIO_OPTION].as<Float>(); // global var
+    spillRatio = max(spillRatio, 0.0l);
+    assert(spillRatio == 0 || ddPackage == CUDD_PACKAGE);
+    assert(spillRatio == 0 || maxMem > 0); // unlimited memory is never under pressure
+
+    assert(!result.count(SPILL_DIR_OPTION) || spillRatio > 0);
+    spillDirPath = result[SPILL_DIR_OPTION].as<string>(); // global var
 
     verboseSolving = result[VERBOSE_SOLVING_OPTION].as<Int>(); // global var
 
@@ -1600,7 +3409,9 @@ OptionDict::OptionDict(int argc, char** argv) {
 
 /* global functions ========================================================= */
 
+#ifndef NO_DMC_MAIN // ddbench links dmc.cc without this main
 int main(int argc, char** argv) {
   cout << std::unitbuf; // enables automatic flushing
   OptionDict(argc, argv);
 }
+#endif
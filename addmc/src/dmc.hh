@@ -20,12 +20,31 @@ using sylvan::gmp_op_max_CALL;
 using sylvan::gmp_op_plus_CALL;
 using sylvan::gmp_op_times_CALL;
 using sylvan::mtbdd_apply_CALL;
+using sylvan::mtbdd_apply_op;
+using sylvan::mtbdd_double;
+using sylvan::mtbdd_false;
 using sylvan::mtbdd_fprintdot_nc;
 using sylvan::mtbdd_getdouble;
+using sylvan::mtbdd_gethigh;
+using sylvan::mtbdd_getlow;
 using sylvan::mtbdd_getvalue;
+using sylvan::mtbdd_getvar;
 using sylvan::mtbdd_gmp;
+using sylvan::mtbdd_invalid;
+using sylvan::mtbdd_isleaf;
 using sylvan::mtbdd_leafcount_more;
 using sylvan::mtbdd_makenode;
+using sylvan::mtbdd_op_max_CALL;
+using sylvan::mtbdd_op_plus_CALL;
+using sylvan::mtbdd_op_times_CALL;
+using sylvan::mtbdd_refs_pop;
+using sylvan::mtbdd_refs_push;
+using sylvan::mtbdd_refs_spawn;
+using sylvan::mtbdd_refs_sync;
+using sylvan::mtbdd_set_from_array;
+using sylvan::mtbdd_true;
+using sylvan::mtbdd_uapply_CALL;
+using sylvan::sylvan_table_usage;
 using sylvan::Mtbdd;
 using sylvan::MTBDD;
 
@@ -52,6 +71,8 @@ const string SUBSTITUTION_MAXIMIZATION_OPTION = "sm";
 const string PLANNER_WAIT_OPTION = "pw";
 const string THREAD_COUNT_OPTION = "tc";
 const string THREAD_SLICE_COUNT_OPTION = "ts";
+const string SLICE_DEADLINE_OPTION = "sd";
+const string SUBTREE_CACHING_OPTION = "sc";
 const string DD_VAR_OPTION = "dv";
 const string SLICE_VAR_OPTION = "sv";
 const string MEM_SENSITIVITY_OPTION = "ms";
@@ -62,6 +83,14 @@ const string MULTIPLE_PRECISION_OPTION = "mp";
 const string JOIN_PRIORITY_OPTION = "jp";
 const string VERBOSE_JOIN_TREE_OPTION = "vj";
 const string VERBOSE_PROFILING_OPTION = "vp";
+const string PROFILE_FILE_OPTION = "pf";
+const string TRACE_FILE_OPTION = "tf";
+const string CHECKPOINT_FILE_OPTION = "cp";
+const string CHECKPOINT_INTERVAL_OPTION = "ci";
+const string SPILL_RATIO_OPTION = "sr";
+const string SPILL_DIR_OPTION = "sf";
+
+const Int SUBTREE_CACHE_WAYS = 4; // slice-bit patterns kept per cached node (LRU); Gray-code order revisits recent patterns first
 
 const map<WeightedCountingMode, string> WEIGHTED_COUNTING_MODES = {
   {WeightedCountingMode::NO_VARS, "NO_VARS"},
@@ -103,15 +132,27 @@ extern Int maximizerFormat;
 extern bool maximizerVerification;
 extern bool substitutionMaximization;
 extern Int threadCount;
-extern Int threadSliceCount; // may be lower or higher than actual number of slices per thread
+extern Int threadSliceCount; // may be lower or higher than actual number of slices per thread (with Sylvan, slices are shared by all workers)
+extern Float sliceDeadline; // in seconds; 0 means slices are never split
+extern bool subtreeCaching;
 extern Float memSensitivity; // in MB (1e6 B)
 extern Float maxMem; // in MB (1e6 B)
 extern string joinPriority;
 extern Int verboseJoinTree; // 1: parsed join tree, 2: raw join tree too
 extern Int verboseProfiling; // 1: sorted stats for CNF vars, 2: unsorted stats for join nodes too
+extern string profileFilePath; // empty means no profile file
+extern string traceFilePath; // empty means no trace file
+extern string checkpointFilePath; // empty means no checkpoint file
+extern Float checkpointInterval; // in seconds
+extern Float spillRatio; // of manager memory limit; 0 means pending DDs are never spilled
+extern string spillDirPath;
 
 extern Int dotFileIndex;
 
+/* types ==================================================================== */
+
+using VarMap = Map<Int, Int>; // Lace macros split arguments on commas
+
 /* classes for processing join trees ======================================== */
 
 class JoinTree { // for JoinTreeProcessor
@@ -120,6 +161,7 @@ public:
   Int declaredClauseCount = MIN_INT;
   Int declaredNodeCount = MIN_INT;
 
+  JoinNodeArena arena; // owns nodes below, which are freed with tree
   Map<Int, JoinTerminal*> joinTerminals; // 0-indexing
   Map<Int, JoinNonterminal*> joinNonterminals; // 0-indexing
 
@@ -155,8 +197,10 @@ public:
   const JoinNonterminal* getJoinTreeRoot() const;
 
   void processCommentLine(const vector<string>& words);
+  void initJoinTree(Int declaredVarCount, Int declaredClauseCount, Int declaredNodeCount); // also adds terminals
   void processProblemLine(const vector<string>& words);
   void processNonterminalLine(const vector<string>& words);
+  void processBinaryProblemLine(const vector<string>& words); // then reads raw bytes of all nonterminals from stdin
 
   void finishReadingJoinTree();
   void readInputStream();
@@ -166,6 +210,35 @@ public:
 
 /* classes for execution ==================================================== */
 
+class SliceDeadlineException : public std::exception { // thrown by CUDD termination handler
+public:
+  string message;
+
+  SliceDeadlineException(const string& message);
+  const char* what() const noexcept override;
+};
+
+class SliceQueue { // shared by slicing threads
+public:
+  vector<Int> sliceVars; // assigned by base slices
+  vector<Int> splitVars; // assigned one by one when slices are split
+  Int sliceCount; // number of base slices
+
+  vector<pair<Int, Int>> threadRanges; // [begin, end) of base slice indices per thread
+  std::deque<Assignment> splitSlices;
+  Int activeSliceCount = 0;
+
+  mutex queueMutex;
+  std::condition_variable queueCondition;
+
+  bool popSlice(Int threadIndex, Assignment& assignment); // waits for work; returns false when all slices are finished
+  void finishSlice();
+  bool isSplittable(const Assignment& assignment) const;
+  void splitSlice(const Assignment& assignment); // replaces unfinished slice with two halves
+
+  SliceQueue(const vector<Int>& outerVars, Int sliceVarCount, Int threadCount);
+};
+
 class SatSolver {
 public:
   CMSat::SATSolver cmsSolver;
@@ -184,15 +257,30 @@ public:
   static size_t prunedDdCount;
   static Float pruningDuration;
 
+  static std::atomic<size_t> spilledDdCount;
+
+  static mutex statsMutex; // Lace workers and slicing threads update stats concurrently
+
+  static vector<pair<Number, Number>> ddVarWeights; // DD var |-> (positive literal weight, negative literal weight)
+  static vector<bool> ddVarAdditiveFlags; // DD var |-> sum (instead of max) abstraction
+  static vector<std::array<Dd, 3>> ddVarWeightLeaves; // Sylvan: DD var |-> leaves of (positive literal weight, negative literal weight, absent var weight)
+  static std::optional<Dd> zeroLeaf; // Sylvan; set with ddVarWeightLeaves
+
   ADD cuadd; // CUDD
   Mtbdd mtbdd; // Sylvan
 
+  mutable std::atomic<size_t> nodeCount = 0; // computed lazily (0 means unknown since every DD has a node); Lace workers may read same handle
+
   size_t getLeafCount() const;
   size_t getNodeCount() const;
+  void updateMaxDdSizes() const; // full traversals; called at join-node boundaries
 
   Dd(const ADD& cuadd);
   Dd(const Mtbdd& mtbdd);
-  Dd(const Dd& dd);
+  Dd(const Dd& dd); // only bumps reference count
+  Dd(Dd&& dd);
+  Dd& operator=(const Dd& dd);
+  Dd& operator=(Dd&& dd);
 
   Number extractConst() const; // does not read logCounting
   static Dd getConstDd(const Number& n, const Cudd* mgr); // reads logCounting
@@ -200,15 +288,23 @@ public:
   static Dd getOneDd(const Cudd* mgr); // returns zero if logCounting
   static Dd getVarDd(Int ddVar, bool val, const Cudd* mgr);
   static const Cudd* newMgr(Float mem, Int threadIndex = 0); // CUDD
+  static void collectGarbage(const Cudd* mgr); // CUDD; also drops computed-table entries with dead nodes
+  static size_t getMemInUse(const Cudd* mgr); // CUDD: bytes; Sylvan: filled unique-table entries
+  static void setDdVarWeights(const vector<Int>& ddVarToCnfVarMap);
+  static void releaseDdVarWeightLeaves(); // before Sylvan quits
+  static Number getAbsentVarWeight(Int ddVar); // factor for abstracting var that does not appear in DD
   bool operator!=(const Dd& rightDd) const;
-  bool operator<(const Dd& rightDd) const; // *this < rightDd (top of priotity queue is rightmost element)
   Dd getComposition(Int ddVar, bool val, const Cudd* mgr) const; // restricts *this to ddVar=val
   Dd getProduct(const Dd& dd) const; // reads logCounting
   Dd getSum(const Dd& dd) const; // reads logCounting
   Dd getMax(const Dd& dd) const; // real max (not 0-1 max)
   Dd getXor(const Dd& dd) const; // must be 0-1 DDs
+  static Dd getNodeDd(Int ddVar, const Dd& highDd, const Dd& lowDd, const Cudd* mgr); // ddVar must be above both children
+  static Dd getParityDd(vector<Int> ddVars, bool parity, const Cudd* mgr); // returns 0-1 DD for XOR(ddVars) == parity
+  static Dd getClauseDd(vector<pair<Int, bool>> ddLiterals, bool xorFlag, const Cudd* mgr); // builds bottom-up in one pass
+  Dd getCofactor(const Map<Int, bool>& ddVarAssignment, const Cudd* mgr) const;
   Set<Int> getSupport() const;
-  Dd getBoolDiff(const Dd& rightDd) const; // returns 0-1 DD for *this >= rightDd
+  Dd getBoolDiff(const Dd& rightDd) const; // returns 0-1 DD for *this >= rightDd (BDD with Sylvan)
   bool evalAssignment(vector<int>& ddVarAssignment) const;
   Dd getAbstraction(
     Int ddVar,
@@ -219,15 +315,198 @@ public:
     vector<pair<Int, Dd>>& maximizationStack,
     const Cudd* mgr
   ) const;
+  Dd getAndAbstraction( // sums or maxes out ddVars from weighted product of *this and dd without building product first
+    const Dd& dd,
+    const vector<Int>& ddVars, // unassigned; must have same additive flag
+    const Cudd* mgr
+  ) const;
+  Dd getCubeAbstraction( // sums or maxes out weighted ddVars in one memoized pass
+    const vector<Int>& ddVars, // unassigned; must have same additive flag
+    const Cudd* mgr
+  ) const;
   Dd getPrunedDd(Float lowerBound, const Cudd* mgr) const;
   void writeDotFile(const Cudd* mgr, const string& dotFileDir = "./") const;
   static void writeInfoFile(const Cudd* mgr, const string& filePath);
+  void writeSpillFile(const string& filePath) const; // CUDD: binary node list, children before parents
+  static Dd readSpillFile(const string& filePath, const Cudd* mgr); // CUDD; also removes file
+};
+
+class SubtreeCache { // one per slicing thread; reuses subtree DDs across base slices
+public:
+  static Map<Int, vector<Int>> frontierSliceVars; // node index |-> slice vars in subtree, for nonterminals with fewer slice vars than parent
+
+  Map<Int, vector<pair<Int, Dd>>> subtreeDds; // node index |-> (slice bits, DD) for recent patterns, most recent last
+  Int hitCount = 0;
+
+  std::optional<Dd> findDd(Int nodeIndex, Int sliceBits); // hit becomes most recent
+  void insertDd(Int nodeIndex, Int sliceBits, const Dd& dd); // evicts least recent pattern beyond SUBTREE_CACHE_WAYS
+
+  static Set<Int> setFrontierSliceVars(const JoinNode* joinRoot, const Set<Int>& sliceVars); // returns slice vars in tree
+  static Int getSliceBits(const vector<Int>& vars, const Assignment& assignment);
+};
+
+class JoinPair { // candidate of JoinScheduler; stale once either factor changes
+public:
+  bool sharingFlag; // factors share support
+  Float sizeEstimate; // upper bound on product size
+  Int i;
+  Int j; // i < j
+  Int iVersion;
+  Int jVersion;
+
+  bool operator<(const JoinPair& joinPair) const; // lower priority: prefers shared support, then estimated product size, then earlier factors
+};
+
+class JoinScheduler { // for --jp s/b; picks pairs of child DDs like tensor-contraction ordering
+public:
+  vector<Dd> factorDds; // only live factors remain after joinFactors
+  vector<Set<Int>> factorSupports; // DD vars
+  vector<Int> factorVersions; // factor index |-> number of changes, or MIN_INT once factor is joined into another
+  Set<Int> pendingDdVars; // projection vars not yet abstracted
+  Map<Int, Int> pendingVarFactorCounts; // pending DD var |-> number of live factors mentioning it
+  bool projectingFlag; // abstracts var once only one factor mentions it
+  const Cudd* mgr;
+
+  void projectPrivateVars(Int factorIndex);
+  JoinPair getJoinPair(Int i, Int j) const; // i < j
+  bool isCurrent(const JoinPair& joinPair) const;
+  void joinFactors(Int factorCount); // multiplies pairs until factorCount factors remain; rescores only pairs with merged factor
+  vector<Int> getPendingDdVars() const;
+  JoinScheduler(
+    vector<Dd>&& childDds,
+    const vector<Int>& projectionDdVars, // unassigned; must have same additive flag if projectingFlag
+    bool projectingFlag,
+    const Cudd* mgr
+  );
+};
+
+class ProfileRecord { // one per join node per slice
+public:
+  Int nodeIndex;
+  Int sliceIndex; // -1 for log-bound and maximizer-verification passes
+  Int threadIndex; // CUDD slicing thread or Lace worker
+  Float seconds; // excludes child subtrees
+  size_t preAbstractionNodes; // joined factors before final abstraction
+  size_t preAbstractionLeaves;
+  size_t postAbstractionNodes;
+  size_t postAbstractionLeaves;
+  Int projectedVarCount;
+  size_t memBytes; // CUDD: memory in use by manager; Sylvan: filled unique-table entries
+  Int gcCount; // cumulative
+};
+
+class Profiler { // per-thread buffers merged at exit
+public:
+  static std::list<vector<ProfileRecord>> threadRecordLists; // stable addresses
+  static thread_local vector<ProfileRecord>* threadRecords;
+  static Map<const Assignment*, Int> sliceIndices; // slice assignment is shared by all Lace tasks of slice
+  static Int sliceCount;
+  static mutex profilerMutex;
+  static std::atomic<Int> sylvanGcCount;
+
+  static bool isEnabled();
+  static void beginSlice(const Assignment* assignment); // also for Tracer
+  static Int getSliceIndex(const Assignment* assignment); // -1 if unregistered
+  static void addRecord(
+    const JoinNode* joinNode,
+    const Assignment& assignment,
+    TimePoint startPoint,
+    size_t preAbstractionNodes,
+    size_t preAbstractionLeaves,
+    const Dd& dd,
+    Int projectedVarCount,
+    const Cudd* mgr
+  );
+  static void writeProfileFile(); // CSV if path ends with ".csv", JSON lines otherwise
+};
+
+class TraceEvent {
+public:
+  string name;
+  char phase; // 'X' for span, 'C' for counter
+  Int threadId;
+  Float startMicroseconds; // since toolStartPoint
+  Float durationMicroseconds; // span
+  Int sliceIndex; // span; -1 if none
+  Int nodeIndex; // span; -1 if none
+  Float value; // counter
+};
+
+class Tracer { // Chrome trace-event format (chrome://tracing or ui.perfetto.dev); per-thread buffers merged at exit
+public:
+  static std::list<vector<TraceEvent>> threadEventLists; // stable addresses
+  static thread_local vector<TraceEvent>* threadEvents;
+  static thread_local Int threadId;
+  static Int tracedThreadCount;
+  static mutex tracerMutex;
+
+  static bool isEnabled();
+  static void addEvent(TraceEvent& event);
+  static void addSpan(const string& name, TimePoint startPoint, Int sliceIndex = -1, Int nodeIndex = -1); // ends now
+  static void addCounter(const string& name, Float value);
+  static void writeTraceFile();
+};
+
+class Checkpointer { // finished slices are written periodically so that interrupted run can resume with same CNF and join tree
+public:
+  static size_t fingerprint; // of CNF, join tree, slice vars and counting settings
+  static vector<pair<Assignment, Number>> finishedSlices; // slice assignment |-> partial solution
+  static vector<Int> slicingVars; // slice vars then split vars, in assignment order
+  static Map<string, Int> finishedSliceIndices; // slice key |-> index in finishedSlices
+  static Set<string> partlyFinishedSliceKeys; // proper prefixes of keys of finished slices
+  static Number totalSolution; // of finished slices
+  static TimePoint writePoint;
+  static mutex checkpointMutex;
+
+  static bool isEnabled();
+  static void writeNumber(ostream& stream, const Number& n); // exact round trip
+  static void writeJoinNode(ostream& stream, const JoinNode* joinRoot); // pre-order, for fingerprint
+  static void setFingerprint(const JoinNonterminal* joinRoot, const vector<Int>& sliceVars);
+  static void readCheckpointFile(const JoinNonterminal* joinRoot, const vector<Int>& sliceVars); // ignores file from different input
+  static string getSliceKey(const Assignment& assignment); // values of first assignment.size() slicing vars
+  static void addFinishedSlice(const Assignment& assignment, const Number& partialSolution); // caller holds checkpointMutex or is only thread
+  static bool isFinished(const Assignment& assignment, Number& partialSolution);
+  static bool isPartlyFinished(const Assignment& assignment); // some split part of slice is finished
+  static void finishSlice(const Assignment& assignment, const Number& partialSolution); // writes file if interval has passed
+  static void writeCheckpointFile(); // via temporary file so that preemption never leaves partial checkpoint
+};
+
+class SubtreeFrame { // nonterminal whose children are being solved by Executor::solveSubtree
+public:
+  const JoinNode* joinNode;
+  const vector<const JoinNode*>& children; // in evaluation order
+  Int position = 0; // of next child to solve
+  Int firstNonterminalPosition = MAX_INT; // Sylvan: later nonterminal children are Lace tasks
+
+  SubtreeCache* subtreeCache = nullptr; // set if DD of joinNode is cached
+  Int sliceBits = 0;
+
+  vector<Int> fusedDdVars; // unassigned projection vars, abstracted while last two factors are multiplied
+  bool fusingFlag = false;
+  Map<Int, vector<Int>> lastMentions; // child position |-> pending vars abstracted once child DD arrives
+
+  Dd dd; // product of folded child DDs
+  Dd lastDd; // multiplied by fused abstraction
+  vector<Dd> childDdList; // child DDs that are joined after all children are solved
+  string spillFilePath; // product of earlier siblings waits on disk while next child is solved
+  vector<string> spillFilePaths; // child position |-> spill file path, or empty if child DD is in memory
+  TimePoint::duration eagerJoinDuration = TimePoint::duration(0); // excludes child subtrees
+
+  SubtreeFrame(const JoinNode* joinNode, const vector<const JoinNode*>& children, const Cudd* mgr);
+  bool isSpawned(Int position) const; // synced when frame reaches position
 };
 
 class Executor {
 public:
   static vector<pair<Int, Dd>> maximizationStack; // pair<DD var, derivative sign>
+  static mutex maximizationStackMutex; // Lace workers push concurrently
+
+  static vector<const Cudd*> threadMgrs; // CUDD; reused across slices
+
+  static const Cudd* getThreadMgr(Int threadIndex, Float mem);
+  static void deleteThreadMgrs();
 
+  static mutex varStatsMutex; // slicing threads and Lace workers update profiling stats concurrently
   static Map<Int, Float> varDurations; // CNF var |-> total execution time in seconds
   static Map<Int, size_t> varDdSizes; // CNF var |-> max DD size
 
@@ -237,33 +516,68 @@ public:
   static void printVarDurations();
   static void printVarDdSizes();
 
-  static Dd getClauseDd(
+  static Map<Int, vector<const JoinNode*>> childOrders; // nonterminal index |-> children in Sethi-Ullman evaluation order
+
+  static Int setChildOrders(const JoinNode* joinRoot); // returns Sethi-Ullman number of tree
+
+  static vector<Map<Int, Dd>> threadClauseDds; // manager thread index |-> clause index |-> clause DD without assignment
+  static mutex clauseDdsMutex; // Sylvan
+
+  static Dd getClauseDd( // cofactors cached clause DD by assignment
     const Map<Int, Int>& cnfVarToDdVarMap,
-    const Clause& clause,
+    Int clauseIndex,
     const Cudd* mgr,
     const Assignment& assignment
   );
-  static Dd solveSubtree( // recursively computes valuation of join tree node
+  static std::atomic<Int> spillFileCount;
+
+  static bool isUnderMemPressure(const Cudd* mgr); // CUDD
+  static string spillDd(Dd& dd, const Cudd* mgr); // writes dd to spill file and releases it; returns file path
+  static Dd reloadDd(const string& filePath, const Cudd* mgr);
+  static Dd solveTerminal(
+    const JoinNode* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const Cudd* mgr,
+    const Assignment& assignment
+  );
+  static std::optional<Dd> enterSubtree( // returns DD of terminal or cached subtree, else pushes frame
+    const JoinNode* joinNode,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    const Assignment& assignment,
+    SubtreeCache* subtreeCache,
+    std::deque<SubtreeFrame>& frames
+  );
+  static void spillBeforeChild(SubtreeFrame& frame, const Cudd* mgr); // under memory pressure
+  static void addChildDd(SubtreeFrame& frame, Dd childDd, const Cudd* mgr, const Assignment& assignment);
+  static Dd finishSubtree( // joins child DDs and abstracts projection vars
+    SubtreeFrame& frame,
+    const Map<Int, Int>& cnfVarToDdVarMap,
+    const vector<Int>& ddVarToCnfVarMap,
+    const Cudd* mgr,
+    const Assignment& assignment
+  );
+  static Dd solveSubtree( // computes valuation of join tree node with explicit stack of frames
     const JoinNode* joinNode,
     const Map<Int, Int>& cnfVarToDdVarMap,
     const vector<Int>& ddVarToCnfVarMap,
     const Cudd* mgr = nullptr,
-    const Assignment& assignment = Assignment()
+    const Assignment& assignment = Assignment(),
+    SubtreeCache* subtreeCache = nullptr // only for base slice assignments
   );
-  static void solveThreadSlices( // sequentially solves all slices in one thread
+  static int hasPassedSliceDeadline(const void* sliceStartPoint); // CUDD termination callback
+  static void throwSliceDeadlineException(string message); // CUDD termination handler; message from CUDD
+  static void solveThreadSlices( // solves slices from queue until all are finished
     const JoinNonterminal* joinRoot,
     const Map<Int, Int>& cnfVarToDdVarMap,
     const vector<Int>& ddVarToCnfVarMap,
     Float threadMem,
     Int threadIndex,
-    const vector<vector<Assignment>>& threadAssignmentLists,
+    SliceQueue& sliceQueue,
     Number& totalSolution,
     mutex& solutionMutex
   );
-  static vector<vector<Assignment>> getThreadAssignmentLists(
-    const JoinNonterminal* joinRoot,
-    Int sliceVarOrderHeuristic
-  );
   static Number solveCnf(
     const JoinNonterminal* joinRoot,
     const Map<Int, Int>& cnfVarToDdVarMap,
@@ -302,6 +616,28 @@ public:
   Executor(const JoinNonterminal* joinRoot, Int ddVarOrderHeuristic, Int sliceVarOrderHeuristic);
 };
 
+/* Lace tasks (Sylvan) ====================================================== */
+
+bool isTrueLeaf(MTBDD leaf); // for 0-1 leaves; reads raw leaf value without Mtbdd wrapper (which would call mtbdd_protect)
+TASK_DECL_2(MTBDD, xorOp, MTBDD*, MTBDD*) // for 0-1 leaves (0 and -inf with logCounting)
+TASK_DECL_2(MTBDD, logProductOp, MTBDD*, MTBDD*) // base-10 log domain
+TASK_DECL_2(MTBDD, logSumExpOp, MTBDD*, MTBDD*) // base-10 log domain
+TASK_DECL_2(MTBDD, logThresholdOp, MTBDD, size_t) // maps leaves below bound (bits of double) to -inf
+TASK_DECL_2(MTBDD, geqOp, MTBDD*, MTBDD*) // returns BDD
+TASK_DECL_3(MTBDD, weightedAndAbstractTask, MTBDD, MTBDD, MTBDD) // see Dd::getAndAbstraction
+VOID_TASK_DECL_0(countGarbageCollection) // Sylvan pre-GC hook for profiling
+
+extern uint64_t weightedAndAbstractOpid; // for Sylvan operation cache
+
+/* CUDD recursive operations ================================================ */
+
+const ptruint DD_ADD_WEIGHTED_AND_ABSTRACT_TAG = 0x82; // computed-table tag: first free slot after DD_VARS_SYMM_BETWEEN_TAG (0x72), last tag in cuddInt.h; op >> 4 is even since it is ORed into cube pointer next to complement bit
+
+DdNode* addWeightedAndAbstractRecur(DdManager* manager, DdNode* f, DdNode* g, DdNode* cube); // see Dd::getAndAbstraction
+
+TASK_DECL_4(MTBDD, solveSubtreeTask, const JoinNode*, const VarMap*, const vector<Int>*, const Assignment*)
+TASK_DECL_6(MTBDD, solveSlicesTask, const JoinNode*, const VarMap*, const vector<Int>*, const vector<Int>*, Int, Int) // sums or maxes slices [firstSlice, firstSlice + sliceCount)
+
 class OptionRequirement {
 public:
   string name;
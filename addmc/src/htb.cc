@@ -4,17 +4,17 @@
 
 /* class JoinComponent ====================================================== */
 
-JoinNonterminal* JoinComponent::getComponentRoot() {
+JoinNonterminal* JoinComponent::getComponentRoot(JoinNodeArena& arena) {
   for (Int clusterIndex = 0; clusterIndex < projectableVars.size(); clusterIndex++) {
     const vector<JoinNode*>& children = nodeClusters.at(clusterIndex);
     if (!children.empty()) {
-      JoinNonterminal* node = new JoinNonterminal(children, projectableVarSets.at(clusterIndex));
+      JoinNonterminal* node = arena.newNonterminal(children, projectableVarSets.at(clusterIndex));
       Int target = node->chooseClusterIndex(clusterIndex, projectableVarSets, clusteringHeuristic);
       nodeClusters.at(target).push_back(node);
     }
   }
 
-  return new JoinNonterminal(nodeClusters.back());
+  return arena.newNonterminal(nodeClusters.back());
 }
 
 Set<Int> JoinComponent::getNodeVars(const vector<JoinNode*>& nodes) const {
@@ -145,10 +145,10 @@ void JoinRootBuilder::setClauseGroups() {
   }
 }
 
-JoinNonterminal* JoinRootBuilder::buildRoot(Int varOrderHeuristic, string clusteringHeuristic) const {
+JoinNonterminal* JoinRootBuilder::buildRoot(JoinNodeArena& arena, Int varOrderHeuristic, string clusteringHeuristic) const {
   vector<JoinTerminal*> terminals;
   for (const Clause& clause : JoinNode::cnf.clauses) {
-    terminals.push_back(new JoinTerminal()); // terminal index = clause index
+    terminals.push_back(arena.newTerminal()); // terminal index = clause index
   }
 
   vector<vector<JoinNode*>> leafBlocks;
@@ -166,7 +166,7 @@ JoinNonterminal* JoinRootBuilder::buildRoot(Int varOrderHeuristic, string cluste
       cout << "c building inner component " << i + 1 << ": started\n";
     }
     JoinComponent innerComponent(varOrderHeuristic, clusteringHeuristic, leafBlocks.at(i), JoinNode::cnf.outerVars);
-    JoinNonterminal* innerRoot = innerComponent.getComponentRoot();
+    JoinNonterminal* innerRoot = innerComponent.getComponentRoot(arena);
     nonterminals.push_back(innerRoot);
     if (verboseSolving >= 2) {
       cout << "c building inner component " << i + 1 << ": ended\n";
@@ -177,7 +177,7 @@ JoinNonterminal* JoinRootBuilder::buildRoot(Int varOrderHeuristic, string cluste
     cout << "c building outer component: started\n";
   }
   JoinComponent outerComponent(varOrderHeuristic, clusteringHeuristic, nonterminals, Set<Int>());
-  JoinNonterminal* outerRoot = outerComponent.getComponentRoot();
+  JoinNonterminal* outerRoot = outerComponent.getComponentRoot(arena);
   if (verboseSolving >= 2) {
     cout << "c building outer component: ended\n";
   }
@@ -197,18 +197,27 @@ JoinRootBuilder::JoinRootBuilder() {
 
 /* class Planner ============================================================ */
 
-void Planner::printJoinTree() const {
-  cout << "p " << JOIN_TREE_WORD << " " << JoinNode::cnf.declaredVarCount << " " << joinRoot->terminalCount << " " << joinRoot->nodeCount << "\n";
-  joinRoot->printSubtree();
+void Planner::printJoinTree(bool binaryJoinTree) const {
+  if (binaryJoinTree) {
+    string bytes;
+    joinRoot->writeSubtree(bytes);
+    cout << "p " << BINARY_JOIN_TREE_WORD << " " << BINARY_JOIN_TREE_VERSION << " " << JoinNode::cnf.declaredVarCount << " " << joinRoot->terminalCount << " " << joinRoot->nodeCount << " " << bytes.size() << "\n";
+    cout.write(bytes.data(), bytes.size());
+    cout << "\n";
+  }
+  else {
+    cout << "p " << JOIN_TREE_WORD << " " << JoinNode::cnf.declaredVarCount << " " << joinRoot->terminalCount << " " << joinRoot->nodeCount << "\n";
+    joinRoot->printSubtree();
+  }
 }
 
-void Planner::outputJoinTree() {
+void Planner::outputJoinTree(bool binaryJoinTree) {
   cout << "c computing output...\n";
 
   setJoinTree();
 
   cout << DASH_LINE;
-  printJoinTree();
+  printJoinTree(binaryJoinTree);
   cout << DASH_LINE;
 
   printRow("joinTreeWidth", joinRoot->getWidth());
@@ -217,7 +226,7 @@ void Planner::outputJoinTree() {
 /* class BucketElimPlanner ================================================== */
 
 void BucketElimPlanner::setJoinTree() {
-  joinRoot = JoinRootBuilder().buildRoot(clusterVarOrderHeuristic, treeClustering ? BUCKET_ELIM_TREE : BUCKET_ELIM_LIST);
+  joinRoot = JoinRootBuilder().buildRoot(arena, clusterVarOrderHeuristic, treeClustering ? BUCKET_ELIM_TREE : BUCKET_ELIM_LIST);
 }
 
 BucketElimPlanner::BucketElimPlanner(bool treeClustering, Int clusterVarOrderHeuristic) {
@@ -228,7 +237,7 @@ BucketElimPlanner::BucketElimPlanner(bool treeClustering, Int clusterVarOrderHeu
 /* class BouquetMethodPlanner =============================================== */
 
 void BouquetMethodPlanner::setJoinTree() {
-  joinRoot = JoinRootBuilder().buildRoot(clusterVarOrderHeuristic, treeClustering ? BOUQUET_METHOD_TREE : BOUQUET_METHOD_LIST);
+  joinRoot = JoinRootBuilder().buildRoot(arena, clusterVarOrderHeuristic, treeClustering ? BOUQUET_METHOD_TREE : BOUQUET_METHOD_LIST);
 }
 
 BouquetMethodPlanner::BouquetMethodPlanner(bool treeClustering, Int clusterVarOrderHeuristic) {
@@ -261,6 +270,7 @@ void OptionDict::runCommand() const {
     printRow("randomSeed", randomSeed);
     printRow("clusterVarOrderHeuristic", (clusterVarOrderHeuristic < 0 ? "INVERSE_" : "") + CNF_VAR_ORDER_HEURISTICS.at(abs(clusterVarOrderHeuristic)));
     printRow("clusteringHeuristic", CLUSTERING_HEURISTICS.at(clusteringHeuristic));
+    printRow("binaryJoinTree", binaryJoinTree);
     cout << "\n";
   }
 
@@ -268,20 +278,20 @@ void OptionDict::runCommand() const {
     JoinNode::cnf.readCnfFile(cnfFilePath);
     if (clusteringHeuristic == BUCKET_ELIM_LIST) {
       BucketElimPlanner bucketElimPlanner(false, clusterVarOrderHeuristic);
-      bucketElimPlanner.outputJoinTree();
+      bucketElimPlanner.outputJoinTree(binaryJoinTree);
     }
     else if (clusteringHeuristic == BUCKET_ELIM_TREE) {
       BucketElimPlanner bucketElimPlanner(true, clusterVarOrderHeuristic);
-      bucketElimPlanner.outputJoinTree();
+      bucketElimPlanner.outputJoinTree(binaryJoinTree);
     }
     else if (clusteringHeuristic == BOUQUET_METHOD_LIST) {
       BouquetMethodPlanner bouquetMethodPlanner(false, clusterVarOrderHeuristic);
-      bouquetMethodPlanner.outputJoinTree();
+      bouquetMethodPlanner.outputJoinTree(binaryJoinTree);
     }
     else {
       assert(clusteringHeuristic == BOUQUET_METHOD_TREE);
       BouquetMethodPlanner bouquetMethodPlanner(true, clusterVarOrderHeuristic);
-      bouquetMethodPlanner.outputJoinTree();
+      bouquetMethodPlanner.outputJoinTree(binaryJoinTree);
     }
   }
   catch (EmptyClauseException) {}
@@ -293,11 +303,12 @@ OptionDict::OptionDict(int argc, char** argv) {
 
   using cxxopts::value;
   options.add_options()
-    (CNF_FILE_OPTION, "CNF file path; string (required)", value<string>())
+    (CNF_FILE_OPTION, "CNF file path, may be pipe or gzip/xz/zstd compressed; string (required)", value<string>())
     (PROJECTED_COUNTING_OPTION, "projected counting (graded join tree): 0, 1; int", value<Int>()->default_value("0"))
     (RANDOM_SEED_OPTION, "random seed; int", value<Int>()->default_value("0"))
     (CLUSTER_VAR_OPTION, helpClusterVarOrderHeuristic(), value<Int>()->default_value(to_string(LEX_P_HEURISTIC)))
     (CLUSTERING_HEURISTIC_OPTION, helpClusteringHeuristic(), value<string>()->default_value(BOUQUET_METHOD_TREE))
+    (BINARY_JOIN_TREE_OPTION, "binary join tree output ('p jtb' problem line then varint-encoded nodes): 0, 1; int", value<Int>()->default_value("0"))
     (VERBOSE_CNF_OPTION, util::helpVerboseCnfProcessing(), value<Int>()->default_value("0"))
     (VERBOSE_SOLVING_OPTION, util::helpVerboseSolving(), value<Int>()->default_value("0"))
     (HELP_OPTION, "help")
@@ -323,6 +334,8 @@ OptionDict::OptionDict(int argc, char** argv) {
     clusteringHeuristic = result[CLUSTERING_HEURISTIC_OPTION].as<string>();
     assert(CLUSTERING_HEURISTICS.contains(clusteringHeuristic));
 
+    binaryJoinTree = result[BINARY_JOIN_TREE_OPTION].as<Int>();
+
     verboseCnf = result[VERBOSE_CNF_OPTION].as<Int>(); // global var
 
     verboseSolving = result[VERBOSE_SOLVING_OPTION].as<Int>(); // global var
@@ -16,6 +16,7 @@ using util::printRow;
 
 const string CLUSTER_VAR_OPTION = "cv";
 const string CLUSTERING_HEURISTIC_OPTION = "ch";
+const string BINARY_JOIN_TREE_OPTION = "bj";
 
 /* classes for planning ===================================================== */
 
@@ -30,7 +31,7 @@ public:
   vector<Set<Int>> projectableVarSets; // {Z_1, ..., Z_m} is a partition of Z
   vector<vector<JoinNode*>> nodeClusters; // kappa_0, ..., kappa_m; kappa_0 is nodeClusters.back()
 
-  JoinNonterminal* getComponentRoot();
+  JoinNonterminal* getComponentRoot(JoinNodeArena& arena);
   Set<Int> getNodeVars(const vector<JoinNode*>& nodes) const;
   vector<Int> getRestrictedVarOrder() const;
 
@@ -54,20 +55,21 @@ public:
   void setInnerVarSets(); // also sets innerVars
   void setClauseGroups();
 
-  JoinNonterminal* buildRoot(Int varOrderHeuristic, string clusteringHeuristic) const;
+  JoinNonterminal* buildRoot(JoinNodeArena& arena, Int varOrderHeuristic, string clusteringHeuristic) const;
 
   JoinRootBuilder();
 };
 
 class Planner { // abstract
 public:
-  JoinNonterminal* joinRoot = nullptr;
+  JoinNodeArena arena;
+  JoinNonterminal* joinRoot = nullptr; // in arena
 
   bool treeClustering; // as opposed to list clustering
   Int clusterVarOrderHeuristic;
 
-  void printJoinTree() const;
-  void outputJoinTree();
+  void printJoinTree(bool binaryJoinTree) const;
+  void outputJoinTree(bool binaryJoinTree);
 
   virtual void setJoinTree() = 0;
 };
@@ -91,6 +93,7 @@ public:
   string cnfFilePath;
   Int clusterVarOrderHeuristic;
   string clusteringHeuristic;
+  bool binaryJoinTree;
 
   static string helpClusterVarOrderHeuristic();
   static string helpClusteringHeuristic();
@@ -10,6 +10,7 @@ Copyright (c) 2020, Jeffrey Dudek
 #include <numeric>
 #include <unordered_set>
 #include <set>
+#include <string>
 #include <vector>
 
 namespace decomposition {
@@ -182,11 +183,11 @@ void JoinTree::compute_projected_variables(const util::Formula &formula) {
   }
 }
 
-void JoinTree::write(std::ostream *output) const {
+size_t JoinTree::count_written_nodes() const {
   // The .jt format uses dummy nodes if clauses have projected variables.
   // Compute the total number of nodes in the tree including these dummy nodes.
-  size_t num_nodes = visit<size_t>([&](const JoinTreeNode &node,
-                                       std::vector<size_t> children) {
+  return visit<size_t>([&](const JoinTreeNode &node,
+                           std::vector<size_t> children) {
     if (children.size() == 0) {
       if (node.projected_variables.size() == 0) {
         return static_cast<size_t>(1);
@@ -203,15 +204,9 @@ void JoinTree::write(std::ostream *output) const {
     }
     return result;
   });
+}
 
-  // Write the join tree header
-  *output << "p jt";
-  *output << " " << highest_projected_var_;
-  *output << " " << highest_leaf_id_+1;
-  *output << " " << num_nodes;
-  *output << "\n";
-
-  // Print out all internal nodes
+void JoinTree::visit_written_nodes(const WrittenNodeVisitor &visitor) const {
   size_t next_id = highest_leaf_id_+2;
   visit<size_t>([&](const JoinTreeNode &node,
                  std::vector<size_t> children) {
@@ -228,23 +223,85 @@ void JoinTree::write(std::ostream *output) const {
       children.push_back(node.clause_id+1);
     }  // Fall-through
 
-    *output << next_id;
+    visitor(next_id, children, node.projected_variables);
+    next_id++;
+    return next_id-1;
+  });
+}
+
+void JoinTree::write(std::ostream *output) const {
+  // Write the join tree header
+  *output << "p jt";
+  *output << " " << highest_projected_var_;
+  *output << " " << highest_leaf_id_+1;
+  *output << " " << count_written_nodes();
+  *output << "\n";
+
+  // Print out all internal nodes
+  visit_written_nodes([&](size_t id, const std::vector<size_t> &children,
+                          const std::vector<size_t> &projected_variables) {
+    *output << id;
     for (size_t child : children) {
       *output << " " << child;
     }
     *output << " e";
-    for (size_t projected : node.projected_variables) {
+    for (size_t projected : projected_variables) {
       *output << " " << projected;
     }
     *output << "\n";
-    next_id++;
-    return next_id-1;
   });
 
   // Print out the join tree width
   *output << "c joinTreeWidth " << width_ << "\n";
 }
 
+namespace {
+// Appends num as an unsigned LEB128 varint
+void write_varint(std::string *bytes, size_t num) {
+  while (num >= 0x80) {
+    bytes->push_back(static_cast<char>((num & 0x7f) | 0x80));
+    num >>= 7;
+  }
+  bytes->push_back(static_cast<char>(num));
+}
+}  // namespace
+
+void JoinTree::write_binary(std::ostream *output) const {
+  // Each internal node is encoded with 0-indexed varints as
+  //   [index] [#children] [index - child]... [#vars] [var - previous var]...
+  std::string bytes;
+  visit_written_nodes([&](size_t id, const std::vector<size_t> &children,
+                          const std::vector<size_t> &projected_variables) {
+    write_varint(&bytes, id-1);
+    write_varint(&bytes, children.size());
+    for (size_t child : children) {
+      write_varint(&bytes, id-child);
+    }
+
+    std::vector<size_t> sorted_variables(projected_variables);
+    std::sort(sorted_variables.begin(), sorted_variables.end());
+    write_varint(&bytes, sorted_variables.size());
+    size_t previous = 0;
+    for (size_t projected : sorted_variables) {
+      write_varint(&bytes, projected - previous);
+      previous = projected;
+    }
+  });
+
+  // The header gives the payload size so that text lines can follow it
+  *output << "p jtb " << kBinaryJoinTreeVersion;
+  *output << " " << highest_projected_var_;
+  *output << " " << highest_leaf_id_+1;
+  *output << " " << count_written_nodes();
+  *output << " " << bytes.size();
+  *output << "\n";
+  output->write(bytes.data(), bytes.size());
+  *output << "\n";
+
+  // Print out the join tree width
+  *output << "c joinTreeWidth " << width_ << "\n";
+}
+
 void JoinTree::compute_width(const util::Formula &formula) {
   width_ = 0;
   visit<std::vector<size_t>>([&] (const JoinTreeNode &node,
@@ -4,6 +4,7 @@ Copyright (c) 2020, Jeffrey Dudek
 
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "decomposition/tree.h"
@@ -17,6 +18,11 @@ Copyright (c) 2020, Jeffrey Dudek
  */
 
 namespace decomposition {
+/**
+ * Version written on the "p jtb" header line of binary join trees.
+ */
+const int kBinaryJoinTreeVersion = 1;
+
 /**
  * A simple class which holds the projected variables at each node.
  */
@@ -54,6 +60,13 @@ class JoinTree {
    */
   void write(std::ostream *output) const;
 
+  /**
+   * Output the join tree in the binary format: a "p jtb" header line giving
+   * the format version, the counts of the text header and the payload size,
+   * followed by the payload of varint-encoded internal nodes.
+   */
+  void write_binary(std::ostream *output) const;
+
   /**
    * Add a leaf to the join tree.
    */
@@ -99,6 +112,20 @@ class JoinTree {
     const decomposition::TreeDecomposition &tree_decomposition);
 
  private:
+  typedef std::function<void(size_t, const std::vector<size_t> &,
+                             const std::vector<size_t> &)> WrittenNodeVisitor;
+
+  /**
+   * Count the nodes in the output, including dummy nodes for leaf projections.
+   */
+  size_t count_written_nodes() const;
+
+  /**
+   * Run "visitor" on the (1-indexed) id, children and projected variables of
+   * every internal node in the output, in postorder.
+   */
+  void visit_written_nodes(const WrittenNodeVisitor &visitor) const;
+
   size_t root_;
   size_t highest_leaf_id_;
   size_t highest_projected_var_;
@@ -17,23 +17,27 @@ int main(int argc, char *argv[]) {
   // Print help message
   if (argc == 2 &&
       (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
-      std::cout << argv[0] << " [TREE DECOMPOSER]" << std::endl;
+      std::cout << argv[0] << " [--binary] [TREE DECOMPOSER]" << std::endl;
       std::cout << "    Use [TREE DECOMPOSER] to make join trees." << std::endl;
       std::cout << "    Input formula is parsed from STDIN." << std::endl;
       std::cout << "    Join trees are written to STDOUT." << std::endl;
+      std::cout << "    With --binary, join trees are written in the compact"
+                << " \"p jtb\" format." << std::endl;
       return 0;
   }
 
-  if (argc != 2) {
-    std::cerr << "Error: Exactly 1 argument required." << std::endl;
+  bool binary = argc == 3 && strcmp(argv[1], "--binary") == 0;
+  if (argc != 2 && !binary) {
+    std::cerr << "Error: Expected [--binary] [TREE DECOMPOSER]." << std::endl;
     return -1;
   }
+  const char *solver_command = argv[argc - 1];
 
   try {
     // Start the tree decomposition solver.
     boost::process::opstream solver_input;
     boost::process::ipstream solver_output;
-    boost::process::child solver(argv[1],
+    boost::process::child solver(solver_command,
                                 boost::process::std_out > solver_output,
                                 boost::process::std_in < solver_input);
 
@@ -74,7 +78,11 @@ int main(int argc, char *argv[]) {
       }
 
       // Output the join tree to stdout.
-      jt->write(&std::cout);
+      if (binary) {
+        jt->write_binary(&std::cout);
+      } else {
+        jt->write(&std::cout);
+      }
 
       auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
         std::chrono::steady_clock::now() - start_time).count();
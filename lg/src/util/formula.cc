@@ -5,10 +5,24 @@ Copyright (c) 2020, Jeffrey Dudek
 #include "util/formula.h"
 
 #include <algorithm>
+#include <csignal>
+#include <limits>
 #include <string_view>
+#include <thread>
+
+#include <boost/process.hpp>
 
 #include "util/dimacs_parser.h"
 
+namespace {
+// Leading bytes of each supported compression format, with its decompressor
+const std::vector<std::pair<std::string, std::string>> kCompressionMagics = {
+  {std::string("\x1f\x8b", 2), "gzip"},
+  {std::string("\xfd\x37\x7a\x58\x5a\x00", 6), "xz"},
+  {std::string("\x28\xb5\x2f\xfd", 4), "zstd"},
+};
+}  // namespace
+
 namespace util {
   bool Formula::add_clause(std::vector<int> literals) {
     for (int literal : literals) {
@@ -32,6 +46,23 @@ namespace util {
   }
 
   std::optional<Formula> Formula::parse_DIMACS(std::istream *stream) {
+    // No valid DIMACS line starts with the first byte of a magic number,
+    // so the rest of the magic is read only when the first byte matches
+    int first_byte = stream->peek();
+    for (const auto &[magic, decompressor] : kCompressionMagics) {
+      if (first_byte == static_cast<unsigned char>(magic[0])) {
+        std::string prefix(magic.size(), '\0');
+        stream->read(prefix.data(), prefix.size());
+        prefix.resize(stream->gcount());
+        if (prefix != magic) {
+          std::cerr << "Parse error: Input is neither DIMACS nor "
+                    << decompressor << " data" << std::endl;
+          return std::nullopt;
+        }
+        return parse_compressed_DIMACS(stream, decompressor, magic);
+      }
+    }
+
     util::DimacsParser parser(stream);
 
     // Parse the header
@@ -115,6 +146,44 @@ namespace util {
     return result;
   }
 
+  std::optional<Formula> Formula::parse_compressed_DIMACS(
+      std::istream *stream, const std::string &decompressor,
+      const std::string &magic) {
+    boost::process::opstream compressed_input;
+    boost::process::ipstream decompressed_output;
+    std::optional<boost::process::child> child;
+    try {
+      child.emplace(decompressor + " -dc",
+                    boost::process::std_out > decompressed_output,
+                    boost::process::std_in < compressed_input);
+    } catch (boost::process::process_error &e) {
+      std::cerr << "Parse error: Unable to run " << decompressor << std::endl;
+      return std::nullopt;
+    }
+
+    // Feed the decompressor from another thread so that neither pipe fills up
+    auto old_handler = std::signal(SIGPIPE, SIG_IGN);
+    std::thread feeder([&]() {
+      compressed_input << magic << stream->rdbuf();
+      compressed_input.flush();
+      compressed_input.pipe().close();
+    });
+
+    std::optional<Formula> result = parse_DIMACS(&decompressed_output);
+
+    // Drain any output left after a parse error so that the feeder finishes
+    decompressed_output.ignore(std::numeric_limits<std::streamsize>::max());
+    feeder.join();
+    std::signal(SIGPIPE, old_handler);
+    child->wait();
+    if (child->exit_code() != 0) {
+      std::cerr << "Parse error: Unable to decompress input with "
+                << decompressor << std::endl;
+      return std::nullopt;
+    }
+    return result;
+  }
+
   GradedClauses Formula::graded_clauses() {
     util::GradedClauses result(clause_variables_);
     // If relevant variables were specified, group using them
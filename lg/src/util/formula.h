@@ -44,12 +44,22 @@ class Formula {
 
   /*
   * Parses a file in DIMACS format into a boolean formula.
+  * Input compressed with gzip, xz or zstd is decompressed on the fly.
   *
   * Returns the parsed formula if the DIMACS file is in a valid format.
   */
   static std::optional<Formula> parse_DIMACS(std::istream *stream);
 
  private:
+  /*
+  * Parses compressed DIMACS input by streaming it through the provided
+  * decompressor (found in PATH). The magic number was already consumed from
+  * the stream and is fed to the decompressor first.
+  */
+  static std::optional<Formula> parse_compressed_DIMACS(
+      std::istream *stream, const std::string &decompressor,
+      const std::string &magic);
+
   // Number of variables in the formula
   size_t num_variables_ = 0;
   // Set of clauses
@@ -0,0 +1,324 @@
+#!/usr/bin/env python3
+
+import argparse
+import csv
+import functools
+import glob
+import itertools
+import json
+import math
+import os
+import signal
+import statistics
+import subprocess
+import time
+
+print = functools.partial(print, flush=True)
+
+LG = 'lg'
+HTB = 'htb'
+
+MC = 'mc'
+WMC = 'wmc'
+PMC = 'pmc'
+PWMC = 'pwmc'
+
+REPORT_FIELDS = [
+    'instance',
+    'planner',
+    'dp',
+    'jp',
+    'dv',
+    'tc',
+    'ts',
+    'runs',
+    'failures',
+    'medianSeconds',
+    'minSeconds',
+    'maxSeconds',
+    'log10Estimate',
+    'goldenMatch',
+]
+CONFIG_FIELDS = REPORT_FIELDS[:7]
+
+def getBinPath(*paths):
+    return os.path.join(os.path.dirname(os.path.realpath(__file__)), *paths)
+
+def getList(arg, cast=str):
+    return [cast(word) for word in arg.split(',') if word]
+
+def addArgs(argParser):
+    argParser.add_argument(
+        'instances',
+        help='CNF files [default: mcc/instances/*.cnf and examples/*cnf]',
+        nargs='*',
+    )
+    argParser.add_argument(
+        '--planners',
+        help=f'comma-separated subset of {LG},{HTB}',
+        default=f'{LG},{HTB}',
+    )
+    argParser.add_argument(
+        '--dp',
+        help='comma-separated dmc --dp values',
+        default='c,s',
+    )
+    argParser.add_argument(
+        '--jp',
+        help='comma-separated dmc --jp values',
+        default='s',
+    )
+    argParser.add_argument(
+        '--dv',
+        help='comma-separated dmc --dv values',
+        default='4',
+    )
+    argParser.add_argument(
+        '--tc',
+        help='comma-separated dmc --tc values',
+        default='1',
+    )
+    argParser.add_argument(
+        '--ts',
+        help='comma-separated dmc --ts values',
+        default='1',
+    )
+    argParser.add_argument(
+        '--repeats',
+        help='runs per config (median is reported)',
+        default=3,
+        type=int,
+    )
+    argParser.add_argument(
+        '--timeout',
+        help='seconds per run',
+        default=600,
+        type=float,
+    )
+    argParser.add_argument(
+        '--width',
+        help='max width of tree decomposition for lg',
+        default=100,
+        type=int,
+    )
+    argParser.add_argument(
+        '--mm',
+        help='dmc --mm value (in MB)',
+        default=4000,
+        type=int,
+    )
+    argParser.add_argument(
+        '--golden',
+        help='CSV file of instance,log10Estimate',
+        default=getBinPath('..', 'benchmark_golden.csv'),
+    )
+    argParser.add_argument(
+        '--update-golden',
+        help='writes golden values from this run instead of checking them',
+        action='store_true',
+    )
+    argParser.add_argument(
+        '--report',
+        help='report file (JSON if path ends with .json, CSV otherwise)',
+        default='benchmark.csv',
+    )
+    argParser.add_argument(
+        '--baseline',
+        help='earlier report to compare median times against',
+    )
+    argParser.add_argument(
+        '--slowdown',
+        help='median-time ratio over baseline that counts as regression',
+        default=1.1,
+        type=float,
+    )
+
+def getDefaultInstances():
+    instances = sorted(glob.glob(getBinPath('..', 'instances', '*.cnf')))
+    instances += sorted(glob.glob(getBinPath('..', '..', 'examples', '*cnf')))
+    return instances
+
+def getCountingMode(cnfPath): # returns (projected, dmc --wc value) as driver.py sets them for task line 'c t <task>'
+    task = None
+    showFlag = False
+    with open(cnfPath) as inFile:
+        for line in inFile:
+            words = line.split()
+            if words[:2] == ['c', 't'] and len(words) > 2:
+                task = words[2]
+            elif words[:3] == ['c', 'p', 'show']:
+                showFlag = True
+    if task is None: # e.g. examples: dmc default weights all vars
+        return (showFlag, 1)
+    return (task in {PMC, PWMC}, 2 if task in {WMC, PWMC} else 0)
+
+def getPlannerCmd(planner, cnfPath, projected, width):
+    if planner == LG:
+        lgArg = f'{getBinPath("flow_cutter_pace17")} -p {width}'
+        return f'{getBinPath("lg")} "{lgArg}" <{cnfPath} 2>/dev/null'
+    return f'{getBinPath("htb")} --cf={cnfPath} --pc={int(projected)} 2>/dev/null'
+
+def getDmcCmd(cnfPath, projected, weightedCounting, config, mm):
+    (dp, jp, dv, tc, ts) = config
+    return ' '.join([
+        getBinPath('dmc'),
+        f'--cf={cnfPath}',
+        f'--wc={weightedCounting}',
+        f'--pc={int(projected)}',
+        f'--dp={dp}',
+        f'--jp={jp}',
+        f'--dv={dv}',
+        f'--tc={tc}',
+        f'--ts={ts}',
+        f'--mm={mm}',
+    ])
+
+def runPipeline(cmd, timeout): # returns (seconds, log10 estimate) or None
+    startTime = time.time()
+    process = subprocess.Popen(
+        cmd,
+        shell=True,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.DEVNULL,
+        text=True,
+        start_new_session=True, # kills planner and dmc together on timeout
+    )
+    try:
+        (output, _) = process.communicate(timeout=timeout)
+    except subprocess.TimeoutExpired:
+        os.killpg(process.pid, signal.SIGKILL)
+        process.communicate()
+        return None
+    seconds = time.time() - startTime
+
+    if process.returncode:
+        return None
+    for line in output.splitlines():
+        words = line.split()
+        if words[:3] == ['c', 's', 'log10-estimate']:
+            return (seconds, float(words[3]))
+    return None
+
+def readGolden(goldenPath):
+    golden = {}
+    if os.path.isfile(goldenPath):
+        with open(goldenPath) as inFile:
+            for row in csv.DictReader(inFile):
+                golden[row['instance']] = float(row['log10Estimate'])
+    return golden
+
+def writeGolden(goldenPath, golden):
+    with open(goldenPath, 'w', newline='') as outFile:
+        writer = csv.writer(outFile)
+        writer.writerow(['instance', 'log10Estimate'])
+        for instance in sorted(golden):
+            writer.writerow([instance, golden[instance]])
+
+def isMatch(estimate, goldenEstimate):
+    if math.isinf(estimate) or math.isinf(goldenEstimate):
+        return estimate == goldenEstimate
+    return abs(estimate - goldenEstimate) <= 1e-5 * max(1, abs(goldenEstimate)) # dmc prints 6 significant digits
+
+def readReport(reportPath):
+    if reportPath.endswith('.json'):
+        with open(reportPath) as inFile:
+            return json.load(inFile)
+    with open(reportPath) as inFile:
+        return list(csv.DictReader(inFile))
+
+def writeReport(reportPath, rows):
+    if reportPath.endswith('.json'):
+        with open(reportPath, 'w') as outFile:
+            json.dump(rows, outFile, indent=2)
+        return
+    with open(reportPath, 'w', newline='') as outFile:
+        writer = csv.DictWriter(outFile, fieldnames=REPORT_FIELDS)
+        writer.writeheader()
+        writer.writerows(rows)
+
+def getConfigKey(row):
+    return tuple(str(row[field]) for field in CONFIG_FIELDS)
+
+def compareBaseline(rows, baselinePath, slowdown): # returns regression count
+    baseline = {getConfigKey(row): row for row in readReport(baselinePath)}
+    regressionCount = 0
+    for row in rows:
+        baseRow = baseline.get(getConfigKey(row))
+        if baseRow is None or not baseRow['medianSeconds'] or not row['medianSeconds']:
+            continue
+        ratio = float(row['medianSeconds']) / float(baseRow['medianSeconds'])
+        if ratio > slowdown:
+            regressionCount += 1
+            print(f'c regression {ratio:.2f}x: {" ".join(getConfigKey(row))}')
+    return regressionCount
+
+def main():
+    formatter = lambda prog: argparse.ArgumentDefaultsHelpFormatter(prog, max_help_position=30)
+    parser = argparse.ArgumentParser(formatter_class=formatter)
+    addArgs(parser)
+    args = parser.parse_args()
+
+    instances = args.instances or getDefaultInstances()
+    configs = list(itertools.product(
+        getList(args.dp),
+        getList(args.jp),
+        getList(args.dv, int),
+        getList(args.tc, int),
+        getList(args.ts, int),
+    ))
+    golden = readGolden(args.golden)
+    mismatchCount = 0
+
+    rows = []
+    for cnfPath in instances:
+        instance = os.path.basename(cnfPath)
+        (projected, weightedCounting) = getCountingMode(cnfPath)
+        for planner in getList(args.planners):
+            for config in configs:
+                cmd = f'{getPlannerCmd(planner, cnfPath, projected, args.width)} | {getDmcCmd(cnfPath, projected, weightedCounting, config, args.mm)}'
+                print(f'c running {args.repeats}x: {cmd}')
+
+                times = []
+                estimates = []
+                for _ in range(args.repeats):
+                    result = runPipeline(cmd, args.timeout)
+                    if result is not None:
+                        times.append(result[0])
+                        estimates.append(result[1])
+
+                goldenMatch = ''
+                if estimates:
+                    if args.update_golden:
+                        golden[instance] = estimates[0]
+                    elif instance in golden:
+                        goldenMatch = all(isMatch(estimate, golden[instance]) for estimate in estimates)
+                        if not goldenMatch:
+                            mismatchCount += 1
+                            print(f'c golden mismatch: {instance} {estimates} != {golden[instance]}')
+
+                row = dict(zip(CONFIG_FIELDS, (instance, planner) + config))
+                row.update({
+                    'runs': args.repeats,
+                    'failures': args.repeats - len(times),
+                    'medianSeconds': statistics.median(times) if times else '',
+                    'minSeconds': min(times) if times else '',
+                    'maxSeconds': max(times) if times else '',
+                    'log10Estimate': estimates[0] if estimates else '',
+                    'goldenMatch': goldenMatch,
+                })
+                rows.append(row)
+
+    writeReport(args.report, rows)
+    print(f'c wrote {len(rows)} rows to {args.report}')
+
+    if args.update_golden:
+        writeGolden(args.golden, golden)
+        print(f'c wrote {len(golden)} golden values to {args.golden}')
+
+    regressionCount = compareBaseline(rows, args.baseline, args.slowdown) if args.baseline else 0
+    failureCount = sum(1 for row in rows if row['failures'])
+    print(f'c failures: {failureCount}, golden mismatches: {mismatchCount}, regressions: {regressionCount}')
+    exit(1 if failureCount or mismatchCount or regressionCount else 0)
+
+if __name__ == '__main__':
+    main()
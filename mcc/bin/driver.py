@@ -34,7 +34,7 @@ def getBinPath(*paths):
 def addArgs(argParser):
     argParser.add_argument(
         'cnf',
-        help='path to benchmark file (stdin unsupported)',
+        help='path to benchmark file, may be gzip/xz/zstd compressed without --pre (stdin unsupported)',
     )
     argParser.add_argument(
         '--task',